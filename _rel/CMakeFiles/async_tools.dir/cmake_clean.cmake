@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/async_tools.dir/main.cpp.o"
+  "CMakeFiles/async_tools.dir/main.cpp.o.d"
+  "async_tools"
+  "async_tools.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/async_tools.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
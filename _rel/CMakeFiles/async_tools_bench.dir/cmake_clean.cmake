@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/async_tools_bench.dir/bench/main.cpp.o"
+  "CMakeFiles/async_tools_bench.dir/bench/main.cpp.o.d"
+  "async_tools_bench"
+  "async_tools_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/async_tools_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
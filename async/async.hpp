@@ -5,6 +5,21 @@
  */
 namespace async{}
 
+#include <async/executor/executor.hpp>
+#include <async/memory/memory.hpp>
+#include <async/timer/timer.hpp>
+#include <async/queue/queue.hpp>
+#include <async/function/function.hpp>
+#include <async/completion/completion.hpp>
+#include <async/rcu/rcu.hpp>
+#include <async/stop/stop.hpp>
+#include <async/metrics/metrics.hpp>
+#include <async/trace/trace.hpp>
+#include <async/batch/batch.hpp>
 #include <async/stream/stream.hpp>
+#include <async/pipeline/pipeline.hpp>
 #include <async/task/task.hpp>
+#include <async/coroutine/coroutine.hpp>
+#include <async/sources/sources.hpp>
+#include <async/text/text.hpp>
 #include <async/utils/utils.hpp>
\ No newline at end of file
@@ -0,0 +1,4 @@
+#pragma once
+#include <async/batch/fwd.h>
+#include <async/batch/decl.h>
+#include <async/batch/impl.h>
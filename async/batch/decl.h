@@ -0,0 +1,117 @@
+#pragma once
+#include <async/batch/fwd.h>
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+/**
+ * A non-owning view over contiguous values
+ * @tparam T The type of values viewed (usually const qualified)
+ */
+template <class T>
+class async::span{
+	public:
+		using element_type = T; ///< @typedef element_type being the type of values viewed
+		using iterator = T*; ///< @typedef iterator being the type of iterators over the values
+		using size_type = std::size_t; ///< @typedef size_type being the type used to count values
+
+	protected:
+		T* first; ///< @property first being a pointer to the first value
+		size_type count; ///< @property count being the amount of values
+
+	public:
+		/**
+		 * Construct an empty span
+		 */
+		constexpr span() : first{nullptr}, count{0}{}
+
+		/**
+		 * Construct a span over the given values
+		 * @param data being a pointer to the first value
+		 * @param size being the amount of values
+		 */
+		constexpr span(T* data, size_type size) : first{data}, count{size}{}
+
+		constexpr T* data() const{ return this->first; }
+		constexpr size_type size() const{ return this->count; }
+		constexpr bool empty() const{ return this->count == 0; }
+		constexpr iterator begin() const{ return this->first; }
+		constexpr iterator end() const{ return this->first + this->count; }
+		T& operator[](size_type i) const{ return this->first[i]; }
+};
+
+/**
+ * An immutable run of contiguous values emitted at once
+ * @tparam T The type of values in the batch
+ */
+template <class T>
+class async::batch{
+	public:
+		using value_type = T; ///< @typedef value_type being the type of values in the batch
+		using const_iterator = const T*; ///< @typedef const_iterator being the type of iterators over the values
+		using size_type = std::size_t; ///< @typedef size_type being the type used to count values
+		using span_type = async::span<const T>; ///< @typedef span_type being the type of view over the values
+
+	protected:
+		T* first = nullptr; ///< @property first being the storage of the values
+		size_type count = 0; ///< @property count being the amount of values
+
+		/**
+		 * Allocate the storage for the given amount of values
+		 * @param size being the amount of values
+		 */
+		void allocate(size_type size);
+
+		/**
+		 * Destroy the values and release the storage
+		 */
+		void release();
+
+	public:
+		/**
+		 * Construct a batch by copying a range of values
+		 * @tparam Iterator - A forward iterator over values convertible to T
+		 * @param begin being the beginning of the range
+		 * @param end being the end of the range
+		 */
+		template <class Iterator>
+		batch(Iterator begin, Iterator end);
+
+		/**
+		 * Construct a batch by transforming a range of values
+		 * @tparam Iterator - A forward iterator
+		 * @tparam Transform - Transform :: (decltype(*begin)) -> T
+		 * @param begin being the beginning of the range
+		 * @param end being the end of the range
+		 * @param transform being the function used to compute each value of the batch
+		 */
+		template <class Iterator, class Transform>
+		batch(Iterator begin, Iterator end, Transform transform);
+
+		/**
+		 * Construct a batch by moving the values out of a vector
+		 * @param values being the values of the batch
+		 */
+		explicit batch(std::vector<T>&& values);
+
+		batch(const batch&) = delete;
+		batch& operator=(const batch&) = delete;
+
+		/**
+		 * Destructor
+		 */
+		~batch(){ this->release(); }
+
+		const T* data() const{ return this->first; }
+		size_type size() const{ return this->count; }
+		bool empty() const{ return this->count == 0; }
+		const_iterator begin() const{ return this->first; }
+		const_iterator end() const{ return this->first + this->count; }
+		const T& operator[](size_type i) const{ return this->first[i]; }
+
+		/**
+		 * Get a view over the values of this batch
+		 * @return a span over the values
+		 */
+		span_type view() const{ return span_type{this->first, this->count}; }
+};
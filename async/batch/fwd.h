@@ -0,0 +1,9 @@
+#pragma once
+
+namespace async{
+	template <class T>
+	class span;
+
+	template <class T>
+	class batch;
+}
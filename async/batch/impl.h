@@ -0,0 +1,74 @@
+#pragma once
+#include <async/batch/decl.h>
+#include <iterator>
+#include <utility>
+#include <new>
+
+#define TPL template <class T>
+#define constructor batch
+#define self async::batch<T>
+#define self_t typename self
+
+TPL
+void self::allocate(self_t::size_type size){
+	this->first = size == 0 ? nullptr : std::allocator<T>{}.allocate(size);
+}
+
+TPL
+void self::release(){
+	for(size_type i = 0 ; i < this->count ; ++i)
+		this->first[i].~T();
+
+	if(this->first)
+		std::allocator<T>{}.deallocate(this->first, this->count);
+
+	this->first = nullptr;
+	this->count = 0;
+}
+
+TPL
+template <class Iterator>
+self::constructor(Iterator begin, Iterator end){
+	const auto size = static_cast<size_type>(std::distance(begin, end));
+	this->allocate(size);
+
+	try{
+		std::uninitialized_copy(begin, end, this->first);
+	}catch(...){
+		std::allocator<T>{}.deallocate(this->first, size);
+		throw;
+	}
+
+	this->count = size;
+}
+
+TPL
+template <class Iterator, class Transform>
+self::constructor(Iterator begin, Iterator end, Transform transform){
+	const auto size = static_cast<size_type>(std::distance(begin, end));
+	this->allocate(size);
+
+	try{
+		for(; begin != end ; ++begin, ++this->count)
+			new(this->first + this->count) T(transform(*begin));
+	}catch(...){
+		const auto constructed = this->count;
+		this->count = 0;
+
+		for(size_type i = 0 ; i < constructed ; ++i)
+			this->first[i].~T();
+
+		std::allocator<T>{}.deallocate(this->first, size);
+		throw;
+	}
+}
+
+TPL
+self::constructor(std::vector<T>&& values)
+: constructor(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end())){
+}
+
+#undef TPL
+#undef constructor
+#undef self
+#undef self_t
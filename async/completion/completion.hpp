@@ -0,0 +1,4 @@
+#pragma once
+#include <async/completion/fwd.h>
+#include <async/completion/decl.h>
+#include <async/completion/impl.h>
@@ -0,0 +1,86 @@
+#pragma once
+#include <async/completion/fwd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace async{
+	namespace details{
+		using park_word = std::atomic<std::uint32_t>;///< @typedef park_word being the type of words threads park on
+
+		/**
+		 * Block the calling thread while the word holds the expected value (may return spuriously)
+		 * @param word being the word to park on
+		 * @param expected being the value the word must hold for the thread to park
+		 * @param timeout being the maximum time to park for (nullptr for no limit)
+		 */
+		inline void park(const park_word& word, std::uint32_t expected, const std::chrono::nanoseconds* timeout);
+
+		/**
+		 * Wake up every thread parked on the word
+		 * @param word being the word threads are parked on
+		 */
+		inline void unpark_all(const park_word& word);
+	}
+}
+
+/**
+ * A one-shot event threads can wait for, without a mutex nor a condition variable: waiters park on
+ * a futex (a hashed parking lot where futexes are not available) and only pay for a wake up if someone waits
+ */
+class async::completion{
+	public:
+		using clock_type = std::chrono::steady_clock;///< @typedef clock_type being the clock used for timed waits
+
+	protected:
+		static constexpr std::uint32_t PENDING = 0;///< @property PENDING being the state of an event nobody waits for yet
+		static constexpr std::uint32_t WAITING = 1;///< @property WAITING being the state of an event some threads wait for
+		static constexpr std::uint32_t DONE = 2;///< @property DONE being the state of an event that happened
+
+		mutable async::details::park_word state{PENDING};///< @property state being the state of the event
+
+		/**
+		 * Wait for the event, for at most the given time
+		 * @param deadline being the time after which to give up (nullptr for no limit)
+		 * @return TRUE if the event happened, FALSE if the deadline has passed
+		 */
+		bool wait_deadline(const clock_type::time_point* deadline) const;
+
+	public:
+		completion() = default;
+		completion(const completion&) = delete;
+		completion& operator=(const completion&) = delete;
+
+		/**
+		 * Signal the event, waking up every waiter
+		 * @return TRUE if this call completed the event, FALSE if it already was
+		 */
+		bool complete();
+
+		/**
+		 * Determine whether or not the event happened
+		 * @return TRUE if the event happened, FALSE otherwise
+		 */
+		bool done() const{ return this->state.load(std::memory_order_acquire) == DONE; }
+
+		/**
+		 * Wait for the event
+		 */
+		void wait() const{ this->wait_deadline(nullptr); }
+
+		/**
+		 * Wait for the event, for at most the given duration
+		 * @param timeout being the maximum time to wait for
+		 * @return TRUE if the event happened, FALSE if the wait timed out
+		 */
+		template <class Rep, class Period>
+		bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const;
+
+		/**
+		 * Wait for the event, until the given time
+		 * @param deadline being the time after which to give up
+		 * @return TRUE if the event happened, FALSE if the wait timed out
+		 */
+		template <class Clock, class Duration>
+		bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const;
+};
@@ -0,0 +1,8 @@
+#pragma once
+#include <memory>
+
+namespace async{
+	class completion;
+
+	using shared_completion = std::shared_ptr<const completion>;
+}
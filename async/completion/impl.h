@@ -0,0 +1,131 @@
+#pragma once
+#include <async/completion/decl.h>
+#include <cstddef>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#include <ctime>
+#define ASYNC_HAS_FUTEX
+#else
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#endif
+
+#ifdef ASYNC_HAS_FUTEX
+inline void async::details::park(const async::details::park_word& word, std::uint32_t expected, const std::chrono::nanoseconds* timeout){
+	static_assert(sizeof(park_word) == sizeof(std::uint32_t), "A futex is a 32 bits word");
+
+	timespec relative;
+	if(timeout){
+		relative.tv_sec = static_cast<time_t>(timeout->count() / 1000000000);
+		relative.tv_nsec = static_cast<long>(timeout->count() % 1000000000);
+	}
+
+	syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout ? &relative : nullptr, nullptr, 0);
+}
+
+inline void async::details::unpark_all(const async::details::park_word& word){
+	syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+#else
+namespace async{
+	namespace details{
+		/**
+		 * A bucket of the parking lot, threads parked on words that hash to the same bucket share it
+		 */
+		struct parking_bucket{
+			std::mutex mutex;
+			std::condition_variable cv;
+		};
+
+		/**
+		 * Retrieve the bucket threads parked on the word sleep in
+		 * @param word being the word to park on
+		 * @return a reference to the bucket
+		 */
+		inline parking_bucket& bucket_of(const park_word& word){
+			static parking_bucket buckets[64];
+			return buckets[std::hash<const void*>{}(&word) % 64];
+		}
+	}
+}
+
+inline void async::details::park(const async::details::park_word& word, std::uint32_t expected, const std::chrono::nanoseconds* timeout){
+	auto& bucket = async::details::bucket_of(word);
+	std::unique_lock<std::mutex> lock{bucket.mutex};
+
+	if(word.load() != expected)
+		return;
+
+	if(timeout)
+		bucket.cv.wait_for(lock, *timeout);
+	else
+		bucket.cv.wait(lock);
+}
+
+inline void async::details::unpark_all(const async::details::park_word& word){
+	auto& bucket = async::details::bucket_of(word);
+	{
+		std::lock_guard<std::mutex> _{bucket.mutex};
+	}
+
+	bucket.cv.notify_all();
+}
+#endif
+
+#undef ASYNC_HAS_FUTEX
+
+#define self async::completion
+
+inline bool self::complete(){
+	const auto previous = this->state.exchange(DONE, std::memory_order_acq_rel);
+
+	if(previous == WAITING)
+		async::details::unpark_all(this->state);
+
+	return previous != DONE;
+}
+
+inline bool self::wait_deadline(const self::clock_type::time_point* deadline) const{
+	auto& word = this->state;
+
+	for(;;){
+		auto current = word.load(std::memory_order_acquire);
+
+		if(current == DONE)
+			return true;
+
+		//Let the completing thread know that it has someone to wake up
+		if(current == PENDING && !word.compare_exchange_weak(current, WAITING, std::memory_order_acq_rel))
+			continue;
+
+		if(!deadline){
+			async::details::park(word, WAITING, nullptr);
+			continue;
+		}
+
+		const auto now = self::clock_type::now();
+		if(now >= *deadline)
+			return false;
+
+		const std::chrono::nanoseconds timeout = *deadline - now;
+		async::details::park(word, WAITING, &timeout);
+	}
+}
+
+template <class Rep, class Period>
+bool self::wait_for(const std::chrono::duration<Rep, Period>& timeout) const{
+	const auto deadline = self::clock_type::now() + std::chrono::duration_cast<self::clock_type::duration>(timeout);
+	return this->wait_deadline(&deadline);
+}
+
+template <class Clock, class Duration>
+bool self::wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const{
+	return this->wait_for(deadline - Clock::now());
+}
+
+#undef self
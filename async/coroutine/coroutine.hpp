@@ -0,0 +1,4 @@
+#pragma once
+#include <async/coroutine/fwd.h>
+#include <async/coroutine/decl.h>
+#include <async/coroutine/impl.h>
@@ -0,0 +1,230 @@
+#pragma once
+#include <async/coroutine/fwd.h>
+
+#ifdef ASYNC_HAS_COROUTINES
+#include <async/stream/decl.h>
+#include <async/executor/fwd.h>
+#include <async/completion/decl.h>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+/**
+ * A task whose body is a coroutine: values are emitted with co_yield and the body may co_await
+ * other streams without blocking a thread, thousands of such tasks share the workers of an executor
+ * @tparam T The type of data that flows in the stream associated to this task
+ *
+ * @warning co_yield emits right away: a full stream whose overflow policy is async::overflow_policy::block blocks the worker
+ */
+template <class T>
+class async::co_task{
+	public:
+		using stream_t = async::stream<T>; ///< @typedef stream_t being the type of stream associated to this task
+		using shared_stream = typename stream_t::shared_stream; ///< @typedef shared_stream being the type of shared stream associated to this task
+		using shared_executor = async::shared_executor; ///< @typedef shared_executor being the type of executor that resumes the coroutine
+
+		/**
+		 * The state of the coroutine, the frame is owned by the async::co_task
+		 */
+		struct promise_type{
+			shared_stream stream_ptr{new stream_t{}}; ///< @property stream_ptr being the stream values are emitted on
+			shared_executor executor_ptr = nullptr; ///< @property executor_ptr being the executor that resumes the coroutine
+			std::shared_ptr<async::completion> finished{new async::completion{}}; ///< @property finished being the event signaled once the body is over
+			std::exception_ptr error{}; ///< @property error being the exception that escaped the body (if any)
+
+			/**
+			 * Signals the end of the body once the coroutine is suspended for good
+			 */
+			struct final_awaiter{
+				bool await_ready() const noexcept{ return false; }
+				void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept;
+				void await_resume() const noexcept{}
+			};
+
+			co_task get_return_object(){ return co_task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+			std::suspend_always initial_suspend() const noexcept{ return {}; }
+			final_awaiter final_suspend() const noexcept{ return {}; }
+			void unhandled_exception(){ this->error = std::current_exception(); }
+			void return_void() const noexcept{}
+
+			/**
+			 * Emit a value on the stream of the task (co_yield value)
+			 * @param value being the value to emit
+			 * @return an awaiter that does not suspend
+			 */
+			std::suspend_never yield_value(T value);
+		};
+
+		using handle_type = std::coroutine_handle<promise_type>; ///< @typedef handle_type being the type of handle to the coroutine
+
+	protected:
+		handle_type handle{}; ///< @property handle being the handle to the coroutine
+		bool started = false; ///< @property started being whether or not the coroutine has been scheduled
+
+		/**
+		 * Construct a task from the handle of its coroutine
+		 * @param handle being the handle to the coroutine
+		 */
+		explicit co_task(handle_type handle) : handle{handle}{}
+
+	public:
+		co_task(co_task&& other) noexcept;
+		co_task& operator=(co_task&&) = delete;
+		co_task(const co_task&) = delete;
+		co_task& operator=(const co_task&) = delete;
+
+		/**
+		 * Destructor, waits for the body (a task that has never been run is closed instead)
+		 */
+		~co_task();
+
+		/**
+		 * Schedule the body on the given executor
+		 * @param executor being the executor that resumes the coroutine (nullptr means async::default_task_executor)
+		 * @return a reference to this task
+		 */
+		co_task& run(shared_executor executor = nullptr);
+
+		/**
+		 * Wait until the body is over and every value has been delivered
+		 * @return a reference to this task
+		 * @throws the exception that escaped the body (if any)
+		 */
+		co_task& wait();
+
+		/**
+		 * Determine whether or not the body is over
+		 * @return TRUE if the body is over, FALSE otherwise
+		 */
+		bool done() const{ return this->handle.promise().finished->done(); }
+
+		/**
+		 * Retrieve the stream associated to this task
+		 * @return a shared pointer to the stream
+		 */
+		shared_stream stream() const{ return this->handle.promise().stream_ptr; }
+};
+
+/**
+ * Reads the values of a stream from a coroutine: co_await next() suspends until a value is delivered
+ * @tparam T The type of data that flows in the stream
+ *
+ * @pre Like any listener, the reader is constructed before the values it must see are emitted
+ */
+template <class T>
+class async::co_reader{
+	public:
+		using stream_t = async::stream<T>; ///< @typedef stream_t being the type of stream read
+		using shared_value = typename stream_t::shared_value; ///< @typedef shared_value being the type of values read
+		using shared_executor = async::shared_executor; ///< @typedef shared_executor being the type of executor that resumes the reader
+
+	protected:
+		/**
+		 * What the reader shares with the listeners it registered
+		 */
+		struct state_type{
+			std::mutex mutex{}; ///< @property mutex being the mutex used to lock the state
+			std::deque<shared_value> values{}; ///< @property values being the values not read yet
+			std::coroutine_handle<> waiter{}; ///< @property waiter being the coroutine waiting for a value (if any)
+			bool closed = false; ///< @property closed being whether or not the stream has been closed
+			bool detached = false; ///< @property detached being whether or not the reader has been destroyed
+			shared_executor executor_ptr; ///< @property executor_ptr being the executor that resumes the waiter
+
+			/**
+			 * Resume the waiter, if any
+			 * @pre The mutex is locked by the caller, which unlocks it right away
+			 */
+			void wake(std::unique_lock<std::mutex>& lock);
+		};
+
+		std::shared_ptr<state_type> state; ///< @property state being the state shared with the listeners
+
+	public:
+		/**
+		 * Awaits the next value of the stream
+		 */
+		struct next_awaiter{
+			std::shared_ptr<state_type> state; ///< @property state being the state of the reader
+
+			bool await_ready() const;
+			bool await_suspend(std::coroutine_handle<> handle) const;
+			shared_value await_resume() const;
+		};
+
+		/**
+		 * Construct a reader and register its listeners
+		 * @param stream being the stream to read
+		 * @param executor being the executor that resumes the reader (nullptr means async::default_task_executor)
+		 */
+		explicit co_reader(stream_t& stream, shared_executor executor = nullptr);
+
+		co_reader(const co_reader&) = delete;
+		co_reader& operator=(const co_reader&) = delete;
+
+		/**
+		 * Destructor, the values delivered afterwards are discarded
+		 */
+		~co_reader();
+
+		/**
+		 * Wait for the next value (co_await reader.next())
+		 * @return an awaiter whose result is the next value, or nullptr once the stream is closed and every value has been read
+		 */
+		next_awaiter next() const{ return next_awaiter{this->state}; }
+};
+
+/**
+ * Moves the awaiting coroutine to the workers of an executor
+ */
+struct async::resume_on_awaiter{
+	async::shared_executor executor_ptr; ///< @property executor_ptr being the executor to resume on
+
+	bool await_ready() const noexcept{ return false; }
+	void await_suspend(std::coroutine_handle<> handle) const;
+	void await_resume() const noexcept{}
+};
+
+/**
+ * Awaits the completion of a stream (closed and every value delivered)
+ * @tparam T The type of data that flows in the stream
+ */
+template <class T>
+struct async::until_closed_awaiter{
+	typename async::stream<T>::shared_stream stream_ptr; ///< @property stream_ptr being the stream to await
+	async::shared_executor executor_ptr; ///< @property executor_ptr being the executor that resumes the coroutine
+
+	bool await_ready() const{ return this->stream_ptr->completion()->done(); }
+	void await_suspend(std::coroutine_handle<> handle) const;
+	void await_resume() const noexcept{}
+};
+
+namespace async{
+	/**
+	 * Resume the calling coroutine on the workers of the given executor (co_await async::resume_on(executor))
+	 * @param executor being the executor to resume on
+	 * @return the awaiter
+	 */
+	inline resume_on_awaiter resume_on(shared_executor executor){ return resume_on_awaiter{std::move(executor)}; }
+
+	/**
+	 * Suspend the calling coroutine until the stream is closed and every value has been delivered (co_await async::until_closed(stream))
+	 * @tparam T The type of data that flows in the stream
+	 * @param stream being the stream to await
+	 * @param executor being the executor that resumes the coroutine (nullptr means async::default_task_executor)
+	 * @return the awaiter
+	 */
+	template <class T>
+	until_closed_awaiter<T> until_closed(std::shared_ptr<stream<T>> stream, shared_executor executor = nullptr);
+
+	/**
+	 * Suspend the calling coroutine until the body of another task is over and its values have been delivered
+	 * @tparam T The type of data that flows in the stream of the task
+	 * @param task being the task to await
+	 * @return the awaiter
+	 */
+	template <class T>
+	until_closed_awaiter<T> operator co_await(const co_task<T>& task);
+}
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * The coroutine layer is only available to C++20 translation units (the rest of the library sticks to C++11)
+ */
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define ASYNC_HAS_COROUTINES 1
+#endif
+
+#ifdef ASYNC_HAS_COROUTINES
+namespace async{
+	template <class T>
+	class co_task;
+
+	template <class T>
+	class co_reader;
+
+	struct resume_on_awaiter;
+
+	template <class T>
+	struct until_closed_awaiter;
+}
+#endif
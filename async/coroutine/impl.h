@@ -0,0 +1,204 @@
+#pragma once
+#include <async/coroutine/decl.h>
+
+#ifdef ASYNC_HAS_COROUTINES
+#include <async/stream/stream.hpp>
+#include <async/executor/executor.hpp>
+#include <async/completion/completion.hpp>
+#include <chrono>
+#include <utility>
+
+#define TPL template <class T>
+#define constructor co_task
+#define self async::co_task<T>
+#define self_t typename self
+
+TPL
+void self::promise_type::final_awaiter::await_suspend(std::coroutine_handle<promise_type> handle) const noexcept{
+	auto& promise = handle.promise();
+
+	//Once completed, the frame may be destroyed by a waiting thread: it must not be touched afterwards
+	const auto finished = promise.finished;
+	promise.stream_ptr->close();
+	finished->complete();
+}
+
+TPL
+std::suspend_never self::promise_type::yield_value(T value){
+	this->stream_ptr->emit(std::move(value));
+	return {};
+}
+
+TPL
+self::constructor(self&& other) noexcept : handle{other.handle}, started{other.started}{
+	other.handle = {};
+	other.started = false;
+}
+
+TPL
+self::~constructor(){
+	if(!this->handle)
+		return;
+
+	if(this->started){
+		try{
+			this->wait();
+		}catch(...){
+		}
+	}else
+		this->handle.promise().stream_ptr->close();
+
+	this->handle.destroy();
+}
+
+TPL
+self& self::run(self_t::shared_executor executor){
+	if(this->started)
+		return *this;
+
+	auto& promise = this->handle.promise();
+	promise.executor_ptr = executor ? executor : async::default_task_executor();
+
+	this->started = true;
+	auto handle = this->handle;
+	promise.executor_ptr->execute([handle]{
+		handle.resume();
+	});
+
+	return *this;
+}
+
+TPL
+self& self::wait(){
+	if(!this->started)
+		return *this;
+
+	auto& promise = this->handle.promise();
+
+	//A worker waiting for a body resumed by its own executor runs the pending jobs meanwhile
+	if(promise.executor_ptr->owns_current_thread()){
+		while(!promise.finished->done()){
+			if(!promise.executor_ptr->run_pending())
+				promise.finished->wait_for(std::chrono::milliseconds{1});
+		}
+	}else
+		promise.finished->wait();
+
+	promise.stream_ptr->wait();
+
+	if(promise.error){
+		auto error = promise.error;
+		promise.error = nullptr;
+		std::rethrow_exception(error);
+	}
+
+	return *this;
+}
+
+#undef self
+#undef constructor
+
+#define constructor co_reader
+#define self async::co_reader<T>
+
+TPL
+void self::state_type::wake(std::unique_lock<std::mutex>& lock){
+	auto waiter = this->waiter;
+	auto executor = this->executor_ptr;
+	this->waiter = {};
+	lock.unlock();
+
+	if(waiter)
+		executor->execute([waiter]{
+			waiter.resume();
+		});
+}
+
+TPL
+self::constructor(self_t::stream_t& stream, self_t::shared_executor executor) : state{new state_type{}}{
+	this->state->executor_ptr = executor ? executor : async::default_task_executor();
+
+	auto state = this->state;
+	stream.onShared([state](const self_t::shared_value& value){
+		std::unique_lock<std::mutex> lock{state->mutex};
+		if(state->detached)
+			return;
+
+		state->values.push_back(value);
+		state->wake(lock);
+	});
+
+	stream.onClose([state]{
+		std::unique_lock<std::mutex> lock{state->mutex};
+		state->closed = true;
+		state->wake(lock);
+	});
+}
+
+TPL
+self::~constructor(){
+	std::lock_guard<std::mutex> _{this->state->mutex};
+	this->state->detached = true;
+	this->state->values.clear();
+}
+
+TPL
+bool self::next_awaiter::await_ready() const{
+	std::lock_guard<std::mutex> _{this->state->mutex};
+	return !this->state->values.empty() || this->state->closed;
+}
+
+TPL
+bool self::next_awaiter::await_suspend(std::coroutine_handle<> handle) const{
+	std::lock_guard<std::mutex> _{this->state->mutex};
+	if(!this->state->values.empty() || this->state->closed)
+		return false;
+
+	this->state->waiter = handle;
+	return true;
+}
+
+TPL
+self_t::shared_value self::next_awaiter::await_resume() const{
+	std::lock_guard<std::mutex> _{this->state->mutex};
+	if(this->state->values.empty())
+		return nullptr;
+
+	auto value = std::move(this->state->values.front());
+	this->state->values.pop_front();
+	return value;
+}
+
+#undef self
+#undef constructor
+
+inline void async::resume_on_awaiter::await_suspend(std::coroutine_handle<> handle) const{
+	this->executor_ptr->execute([handle]{
+		handle.resume();
+	});
+}
+
+TPL
+void async::until_closed_awaiter<T>::await_suspend(std::coroutine_handle<> handle) const{
+	//The listener may run right away (on this thread) if the stream is already done
+	auto executor = this->executor_ptr;
+	this->stream_ptr->onClose([handle, executor]{
+		executor->execute([handle]{
+			handle.resume();
+		});
+	});
+}
+
+TPL
+async::until_closed_awaiter<T> async::until_closed(std::shared_ptr<async::stream<T>> stream, async::shared_executor executor){
+	return until_closed_awaiter<T>{std::move(stream), executor ? executor : async::default_task_executor()};
+}
+
+TPL
+async::until_closed_awaiter<T> async::operator co_await(const async::co_task<T>& task){
+	return async::until_closed(task.stream());
+}
+
+#undef self_t
+#undef TPL
+#endif
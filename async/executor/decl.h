@@ -0,0 +1,261 @@
+#pragma once
+#include <async/executor/fwd.h>
+#include <async/queue/decl.h>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <type_traits>
+#include <cstddef>
+
+/**
+ * An object that runs jobs on behalf of streams and tasks
+ */
+class async::executor{
+	public:
+		using job_type = std::function<void()>; ///< @typedef job_type being the type of jobs that can be executed
+
+		/**
+		 * Destructor
+		 */
+		virtual ~executor() = default;
+
+		/**
+		 * Schedule a job for execution
+		 * @param job being the job to execute
+		 *
+		 * @post The job will eventually be executed
+		 */
+		virtual void execute(job_type job) = 0;
+
+		/**
+		 * Determine whether or not the calling thread is one of this executor's workers
+		 * @return TRUE if the calling thread belongs to this executor, FALSE otherwise
+		 */
+		virtual bool owns_current_thread() const{ return false; }
+
+		/**
+		 * Retrieve the number of jobs this executor can run in parallel
+		 * @return the amount of workers of this executor
+		 */
+		virtual std::size_t concurrency() const{ return 1; }
+
+		/**
+		 * Run one of the jobs waiting for a worker on the calling thread, used to make progress while blocked
+		 * @return TRUE if a job has been run, FALSE otherwise
+		 */
+		virtual bool run_pending(){ return false; }
+
+		/**
+		 * Make sure the jobs waiting for a worker keep running while the calling worker is blocked (eg. by starting a temporary
+		 * worker), used instead of async::executor::run_pending when running a job here could re-enter what the calling thread is doing
+		 * @pre Called from one of this executor's workers
+		 */
+		virtual void compensate(){}
+
+		/**
+		 * Schedule a job for execution and get notified of its result
+		 * @tparam F - F :: () -> R
+		 * @param f being the job to execute
+		 * @return a future that holds the result of the job
+		 */
+		template <class F>
+		std::future<typename std::result_of<F()>::type> submit(F f);
+};
+
+/**
+ * An executor that runs jobs on the calling thread, right away
+ */
+class async::inline_executor : public async::executor{
+	public:
+		void execute(job_type job) override;
+};
+
+/**
+ * A fixed-size pool of persistent worker threads sharing a FIFO job queue
+ */
+class async::thread_pool : public async::executor{
+	protected:
+		std::mutex mutex{}; ///< @property mutex being the mutex used to lock the job queue
+		std::condition_variable cv{}; ///< @property cv being the condition variable workers sleep on
+		std::deque<job_type> jobs{}; ///< @property jobs being the queue of pending jobs
+		std::vector<std::thread> workers{}; ///< @property workers being the threads of this pool
+		bool stopping = false; ///< @property stopping being the flag used to shutdown the workers
+		std::size_t idle = 0; ///< @property idle being the amount of workers waiting for a job
+		std::size_t extra = 0; ///< @property extra being the amount of temporary workers started by async::thread_pool::compensate
+		std::size_t starting = 0; ///< @property starting being the amount of temporary workers that have not taken a job yet
+
+		/**
+		 * The loop run by each worker
+		 */
+		void work();
+
+		/**
+		 * The loop run by a temporary worker: it runs jobs until there is none left
+		 */
+		void work_extra();
+
+	public:
+		/**
+		 * Construct a pool with the given amount of workers
+		 * @param size being the amount of workers (0 means one per hardware thread)
+		 */
+		explicit thread_pool(std::size_t size = 0);
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		/**
+		 * Destructor, runs the remaining jobs and joins the workers (it may be run by one of them, when a job releases the last reference to the pool)
+		 */
+		~thread_pool();
+
+		void execute(job_type job) override;
+		bool owns_current_thread() const override;
+		std::size_t concurrency() const override{ return this->workers.size(); }
+		bool run_pending() override;
+		void compensate() override;
+};
+
+/**
+ * An executor that runs each job on its own dedicated thread (suited for long blocking jobs)
+ */
+class async::dedicated_thread_executor : public async::executor{
+	protected:
+		std::mutex mutex{}; ///< @property mutex being the mutex used to lock the thread count
+		std::condition_variable cv{}; ///< @property cv being the condition variable used to wait for the threads
+		std::size_t active = 0; ///< @property active being the amount of threads still running
+
+	public:
+		dedicated_thread_executor() = default;
+		dedicated_thread_executor(const dedicated_thread_executor&) = delete;
+		dedicated_thread_executor& operator=(const dedicated_thread_executor&) = delete;
+
+		/**
+		 * Destructor, waits for every running job
+		 */
+		~dedicated_thread_executor();
+
+		void execute(job_type job) override;
+		std::size_t concurrency() const override;
+};
+
+/**
+ * A fixed-size pool of workers that each own a deque of jobs and steal from the others when theirs is empty
+ * (jobs scheduled by a worker stay on its deque, other threads go through a shared injection queue)
+ */
+class async::work_stealing_pool : public async::executor{
+	public:
+		using deque_type = async::work_stealing_deque<job_type*>; ///< @typedef deque_type being the type of deque owned by each worker
+
+	protected:
+		std::vector<std::unique_ptr<deque_type>> deques{}; ///< @property deques being the deque of each worker
+		std::vector<std::vector<std::size_t>> victims{}; ///< @property victims being, for each worker, the workers to steal from (same NUMA node first)
+
+		std::mutex injectionMutex{}; ///< @property injectionMutex being the mutex used to lock the injection queue
+		std::deque<job_type*> injected{}; ///< @property injected being the jobs scheduled from outside the pool
+		std::atomic<std::size_t> injectedCount{0}; ///< @property injectedCount being the amount of jobs in the injection queue
+
+		std::mutex sleepMutex{}; ///< @property sleepMutex being the mutex idle workers sleep with
+		std::condition_variable sleepCv{}; ///< @property sleepCv being the condition variable idle workers sleep on
+		std::atomic<std::size_t> sleepers{0}; ///< @property sleepers being the amount of workers about to sleep or sleeping
+		bool stopping = false; ///< @property stopping being the flag used to shutdown the workers
+		std::size_t extra = 0; ///< @property extra being the amount of temporary workers started by async::work_stealing_pool::compensate (locked by sleepMutex)
+		std::size_t starting = 0; ///< @property starting being the amount of temporary workers that have not taken a job yet (locked by sleepMutex)
+
+		std::vector<std::thread> workers{}; ///< @property workers being the threads of this pool
+
+		/**
+		 * The loop run by each worker
+		 * @param index being the index of the worker
+		 * @param cpu being the CPU to pin the worker to (or -1)
+		 */
+		void work(std::size_t index, int cpu);
+
+		/**
+		 * The loop run by a temporary worker: it steals jobs until there is none left
+		 */
+		void work_extra();
+
+		/**
+		 * Find a job for a worker: from its own deque, then the injection queue, then its victims
+		 * @param index being the index of the worker (or the amount of workers for a thread outside the pool)
+		 * @return the job (owned by the caller) or nullptr if there is none
+		 */
+		job_type* find_job(std::size_t index);
+
+		/**
+		 * Take a job from the injection queue
+		 * @return the job (owned by the caller) or nullptr if there is none
+		 */
+		job_type* take_injected();
+
+		/**
+		 * Determine whether or not there is a job waiting somewhere in the pool
+		 * @return TRUE if a job is waiting, FALSE otherwise
+		 */
+		bool has_work() const;
+
+		/**
+		 * Wake up a sleeping worker, if any
+		 */
+		void wake_one();
+
+	public:
+		/**
+		 * Construct a pool with the given amount of workers
+		 * @param size being the amount of workers (0 means one per hardware thread, at least 2)
+		 * @param pin being whether or not to pin each worker to a CPU (Linux only)
+		 */
+		explicit work_stealing_pool(std::size_t size = 0, bool pin = false);
+
+		work_stealing_pool(const work_stealing_pool&) = delete;
+		work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+		/**
+		 * Destructor, runs the remaining jobs and joins the workers (it may be run by one of them, when a job releases the last reference to the pool)
+		 */
+		~work_stealing_pool();
+
+		void execute(job_type job) override;
+		bool owns_current_thread() const override;
+		std::size_t concurrency() const override{ return this->workers.size(); }
+		bool run_pending() override;
+		void compensate() override;
+};
+
+namespace async{
+	namespace details{
+		/**
+		 * Retrieve the NUMA node of each CPU
+		 * @return the node of each CPU, indexed by CPU (every CPU is on node 0 when the topology is unknown)
+		 */
+		inline std::vector<std::size_t> numa_nodes();
+
+		/**
+		 * Make sure the jobs of the pool the calling thread works for (if any) keep running while it blocks, whichever
+		 * executor it blocks on (see async::executor::compensate)
+		 */
+		inline void compensate_current_thread();
+	}
+
+	/**
+	 * Retrieve the executor shared by streams that have not been given one (a process-wide thread pool)
+	 * @return the default stream executor
+	 */
+	shared_executor default_executor();
+
+	/**
+	 * Retrieve the executor shared by tasks that have not been given one (a process-wide work-stealing pool)
+	 * @return the default task executor
+	 * @warning Its workers are few and shared by every task: a handler that blocks (on a file, a socket, a lock) holds one
+	 * for as long as it blocks, give such tasks an async::dedicated_thread_executor instead (blocking on a full stream is fine,
+	 * the pool starts a temporary worker meanwhile, see async::details::compensate_current_thread)
+	 */
+	shared_executor default_task_executor();
+}
@@ -0,0 +1,4 @@
+#pragma once
+#include <async/executor/fwd.h>
+#include <async/executor/decl.h>
+#include <async/executor/impl.h>
@@ -0,0 +1,12 @@
+#pragma once
+#include <memory>
+
+namespace async{
+	class executor;
+	class inline_executor;
+	class thread_pool;
+	class dedicated_thread_executor;
+	class work_stealing_pool;
+
+	using shared_executor = std::shared_ptr<executor>; ///< @typedef shared_executor being the type that designates a shared pointer to an executor
+}
@@ -0,0 +1,558 @@
+#pragma once
+#include <async/executor/decl.h>
+#include <async/queue/queue.hpp>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+template <class F>
+std::future<typename std::result_of<F()>::type> async::executor::submit(F f){
+	using result_type = typename std::result_of<F()>::type;
+
+	auto job = std::make_shared<std::packaged_task<result_type()>>(std::move(f));
+	auto future = job->get_future();
+	this->execute([job]{ (*job)(); });
+	return future;
+}
+
+
+inline void async::inline_executor::execute(job_type job){
+	job();
+}
+
+
+namespace async{
+	namespace details{
+		/**
+		 * Retrieve the pool the calling thread works for
+		 * @return a reference to the thread local pool pointer
+		 */
+		inline async::thread_pool*& current_pool(){
+			static thread_local async::thread_pool* pool = nullptr;
+			return pool;
+		}
+	}
+}
+
+#define self async::thread_pool
+#define constructor thread_pool
+
+inline self::constructor(std::size_t size){
+	if(size == 0)
+		size = std::max<std::size_t>(2, std::thread::hardware_concurrency());
+
+	this->workers.reserve(size);
+	for(std::size_t i = 0 ; i < size ; ++i)
+		this->workers.emplace_back([this]{ this->work(); });
+}
+
+inline self::~constructor(){
+	{
+		std::lock_guard<std::mutex> _{this->mutex};
+		this->stopping = true;
+	}
+
+	this->cv.notify_all();
+
+	//The last reference to a pool may be released by one of its own jobs: that worker cannot join itself
+	const bool fromWorker = this->owns_current_thread();
+	const auto currentThread = std::this_thread::get_id();
+	bool fromExtra = fromWorker;
+
+	for(auto& worker : this->workers){
+		if(worker.get_id() == currentThread){
+			worker.detach();
+			fromExtra = false;
+		}else
+			worker.join();
+	}
+
+	{
+		//Temporary workers are detached, wait for them to run out of jobs
+		std::unique_lock<std::mutex> lock{this->mutex};
+		this->cv.wait(lock, [&]{ return this->extra == (fromExtra ? 1u : 0u); });
+	}
+
+	if(!fromWorker)
+		return;
+
+	async::details::current_pool() = nullptr;
+	while(this->run_pending());
+}
+
+inline void self::execute(job_type job){
+	{
+		std::lock_guard<std::mutex> _{this->mutex};
+		this->jobs.push_back(std::move(job));
+	}
+
+	this->cv.notify_one();
+}
+
+inline bool self::owns_current_thread() const{
+	return async::details::current_pool() == this;
+}
+
+inline bool self::run_pending(){
+	job_type job;
+
+	{
+		std::lock_guard<std::mutex> _{this->mutex};
+		if(this->jobs.empty())
+			return false;
+
+		job = std::move(this->jobs.front());
+		this->jobs.pop_front();
+	}
+
+	job();
+	return true;
+}
+
+inline void self::compensate(){
+	{
+		std::lock_guard<std::mutex> _{this->mutex};
+		if(this->stopping || this->jobs.empty() || this->idle != 0 || this->starting != 0)
+			return;
+
+		++this->extra;
+		++this->starting;
+	}
+
+	std::thread{[this]{ this->work_extra(); }}.detach();
+}
+
+inline void self::work(){
+	async::details::current_pool() = this;
+
+	for(;;){
+		job_type job;
+
+		{
+			std::unique_lock<std::mutex> lock{this->mutex};
+			++this->idle;
+			this->cv.wait(lock, [this]{ return this->stopping || !this->jobs.empty(); });
+			--this->idle;
+
+			if(this->jobs.empty())
+				return;
+
+			job = std::move(this->jobs.front());
+			this->jobs.pop_front();
+		}
+
+		job();
+		job = nullptr;
+
+		//Releasing the job may have destroyed this pool
+		if(async::details::current_pool() != this)
+			return;
+	}
+}
+
+inline void self::work_extra(){
+	async::details::current_pool() = this;
+	bool first = true;
+
+	for(;;){
+		job_type job;
+
+		{
+			std::lock_guard<std::mutex> _{this->mutex};
+			if(first){
+				--this->starting;
+				first = false;
+			}
+
+			if(this->jobs.empty()){
+				--this->extra;
+				this->cv.notify_all();
+				return;
+			}
+
+			job = std::move(this->jobs.front());
+			this->jobs.pop_front();
+		}
+
+		job();
+		job = nullptr;
+
+		//Releasing the job may have destroyed this pool
+		if(async::details::current_pool() != this)
+			return;
+	}
+}
+
+#undef self
+#undef constructor
+
+
+#define self async::dedicated_thread_executor
+#define constructor dedicated_thread_executor
+
+inline self::~constructor(){
+	std::unique_lock<std::mutex> lock{this->mutex};
+	this->cv.wait(lock, [this]{ return this->active == 0; });
+}
+
+inline void self::execute(job_type job){
+	{
+		std::lock_guard<std::mutex> _{this->mutex};
+		++this->active;
+	}
+
+	std::thread{[this](job_type job){
+		job();
+
+		std::lock_guard<std::mutex> _{this->mutex};
+		--this->active;
+		this->cv.notify_all();
+	}, std::move(job)}.detach();
+}
+
+inline std::size_t self::concurrency() const{
+	return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+#undef self
+#undef constructor
+
+
+namespace async{
+	namespace details{
+		/**
+		 * Who the calling thread works for
+		 */
+		struct worker_identity{
+			async::work_stealing_pool* pool; ///< @property pool being the pool the thread works for (or nullptr)
+			std::size_t index; ///< @property index being the index of the thread in the pool
+		};
+
+		/**
+		 * Retrieve the work-stealing pool the calling thread works for
+		 * @return a reference to the thread local identity
+		 */
+		inline worker_identity& current_worker(){
+			static thread_local worker_identity identity{nullptr, 0};
+			return identity;
+		}
+	}
+}
+
+inline std::vector<std::size_t> async::details::numa_nodes(){
+	const auto cpus = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	std::vector<std::size_t> nodes(cpus, 0);
+
+	#if defined(__linux__)
+	for(std::size_t node = 0 ; node < 64 ; ++node){
+		std::ifstream file{"/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"};
+		if(!file.is_open())
+			continue;
+
+		//eg. "0-3,8-11"
+		std::string range;
+		while(std::getline(file, range, ',')){
+			std::istringstream in{range};
+			std::size_t first, last;
+			char dash;
+
+			if(!(in >> first))
+				continue;
+
+			if(!(in >> dash >> last))
+				last = first;
+
+			for(auto cpu = first ; cpu <= last && cpu < cpus ; ++cpu)
+				nodes[cpu] = node;
+		}
+	}
+	#endif
+
+	return nodes;
+}
+
+#define self async::work_stealing_pool
+#define constructor work_stealing_pool
+
+inline self::constructor(std::size_t size, bool pin){
+	if(size == 0)
+		size = std::max<std::size_t>(2, std::thread::hardware_concurrency());
+
+	//Worker i is meant to run on CPU i (modulo the amount of CPUs), it steals from the workers of its NUMA node first
+	const auto nodes = async::details::numa_nodes();
+	const auto nodeOf = [&](std::size_t worker){ return nodes[worker % nodes.size()]; };
+
+	this->victims.resize(size);
+	for(std::size_t i = 0 ; i < size ; ++i){
+		this->deques.emplace_back(new deque_type{});
+
+		for(std::size_t distance = 1 ; distance < size ; ++distance){
+			const auto victim = (i + distance) % size;
+			if(nodeOf(victim) == nodeOf(i))
+				this->victims[i].push_back(victim);
+		}
+
+		for(std::size_t distance = 1 ; distance < size ; ++distance){
+			const auto victim = (i + distance) % size;
+			if(nodeOf(victim) != nodeOf(i))
+				this->victims[i].push_back(victim);
+		}
+	}
+
+	this->workers.reserve(size);
+	for(std::size_t i = 0 ; i < size ; ++i){
+		const int cpu = pin ? static_cast<int>(i % nodes.size()) : -1;
+		this->workers.emplace_back([this, i, cpu]{ this->work(i, cpu); });
+	}
+}
+
+inline self::~constructor(){
+	{
+		std::lock_guard<std::mutex> _{this->sleepMutex};
+		this->stopping = true;
+	}
+
+	this->sleepCv.notify_all();
+
+	//The last reference to a pool may be released by one of its own jobs: that worker cannot join itself
+	const bool fromWorker = this->owns_current_thread();
+	const auto currentThread = std::this_thread::get_id();
+
+	const bool fromExtra = fromWorker && async::details::current_worker().index >= this->deques.size();
+
+	for(auto& worker : this->workers){
+		if(worker.get_id() == currentThread)
+			worker.detach();
+		else
+			worker.join();
+	}
+
+	{
+		//Temporary workers are detached, wait for them to run out of jobs
+		std::unique_lock<std::mutex> lock{this->sleepMutex};
+		this->sleepCv.wait(lock, [&]{ return this->extra == (fromExtra ? 1u : 0u); });
+	}
+
+	if(fromWorker){
+		async::details::current_worker().pool = nullptr;
+		while(this->run_pending());
+	}
+}
+
+inline void self::execute(job_type job){
+	std::unique_ptr<job_type> owned{new job_type(std::move(job))};
+	const auto& identity = async::details::current_worker();
+
+	if(identity.pool == this && identity.index < this->deques.size()){
+		this->deques[identity.index]->push(owned.release());
+	}else{
+		std::lock_guard<std::mutex> _{this->injectionMutex};
+		this->injected.push_back(owned.get());
+		owned.release();
+		++this->injectedCount;
+	}
+
+	this->wake_one();
+}
+
+inline bool self::owns_current_thread() const{
+	return async::details::current_worker().pool == this;
+}
+
+inline bool self::run_pending(){
+	const auto& identity = async::details::current_worker();
+	std::unique_ptr<job_type> job{this->find_job(identity.pool == this ? identity.index : this->deques.size())};
+
+	if(!job)
+		return false;
+
+	(*job)();
+	return true;
+}
+
+inline void self::compensate(){
+	{
+		std::lock_guard<std::mutex> _{this->sleepMutex};
+		if(this->stopping || this->sleepers.load() != 0 || this->starting != 0 || !this->has_work())
+			return;
+
+		++this->extra;
+		++this->starting;
+	}
+
+	std::thread{[this]{ this->work_extra(); }}.detach();
+}
+
+inline self::job_type* self::take_injected(){
+	if(this->injectedCount.load() == 0)
+		return nullptr;
+
+	std::lock_guard<std::mutex> _{this->injectionMutex};
+	if(this->injected.empty())
+		return nullptr;
+
+	auto* job = this->injected.front();
+	this->injected.pop_front();
+	--this->injectedCount;
+	return job;
+}
+
+inline self::job_type* self::find_job(std::size_t index){
+	job_type* job = nullptr;
+
+	if(index < this->deques.size() && this->deques[index]->pop(job))
+		return job;
+
+	if((job = this->take_injected()))
+		return job;
+
+	if(index < this->victims.size()){
+		for(const auto victim : this->victims[index]){
+			if(this->deques[victim]->steal(job))
+				return job;
+		}
+	}else{
+		for(const auto& deque : this->deques){
+			if(deque->steal(job))
+				return job;
+		}
+	}
+
+	return nullptr;
+}
+
+inline bool self::has_work() const{
+	if(this->injectedCount.load() != 0)
+		return true;
+
+	for(const auto& deque : this->deques){
+		if(!deque->empty())
+			return true;
+	}
+
+	return false;
+}
+
+inline void self::wake_one(){
+	//Pairs with the fence of a worker going to sleep: either it sees the job, or this sees it as a sleeper
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(this->sleepers.load(std::memory_order_relaxed) == 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> _{this->sleepMutex};
+	}
+
+	this->sleepCv.notify_one();
+}
+
+inline void self::work(std::size_t index, int cpu){
+	auto& identity = async::details::current_worker();
+	identity.pool = this;
+	identity.index = index;
+
+	#if defined(__linux__)
+	if(cpu >= 0){
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	}
+	#else
+	(void)cpu;
+	#endif
+
+	for(;;){
+		std::unique_ptr<job_type> job{this->find_job(index)};
+
+		if(job){
+			(*job)();
+			job.reset();
+
+			//Releasing the job may have destroyed this pool
+			if(async::details::current_worker().pool != this)
+				return;
+
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{this->sleepMutex};
+		++this->sleepers;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if(this->has_work()){
+			--this->sleepers;
+			continue;
+		}
+
+		if(this->stopping){
+			--this->sleepers;
+			return;
+		}
+
+		this->sleepCv.wait(lock);
+		--this->sleepers;
+	}
+}
+
+inline void self::work_extra(){
+	//Temporary workers have no deque of their own: they take injected jobs and steal from every worker
+	auto& identity = async::details::current_worker();
+	identity.pool = this;
+	identity.index = this->deques.size();
+	bool first = true;
+
+	for(;;){
+		std::unique_ptr<job_type> job{this->find_job(identity.index)};
+
+		if(first || !job){
+			std::lock_guard<std::mutex> _{this->sleepMutex};
+			if(first){
+				--this->starting;
+				first = false;
+			}
+
+			if(!job){
+				--this->extra;
+				this->sleepCv.notify_all();
+				return;
+			}
+		}
+
+		(*job)();
+		job.reset();
+
+		//Releasing the job may have destroyed this pool
+		if(async::details::current_worker().pool != this)
+			return;
+	}
+}
+
+#undef self
+#undef constructor
+
+
+inline void async::details::compensate_current_thread(){
+	//A thread works for one pool at most
+	if(auto* pool = async::details::current_pool())
+		pool->compensate();
+	else if(auto* pool = async::details::current_worker().pool)
+		pool->compensate();
+}
+
+inline async::shared_executor async::default_executor(){
+	static shared_executor executor = std::make_shared<async::thread_pool>();
+	return executor;
+}
+
+inline async::shared_executor async::default_task_executor(){
+	static shared_executor executor = std::make_shared<async::work_stealing_pool>();
+	return executor;
+}
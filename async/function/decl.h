@@ -0,0 +1,120 @@
+#pragma once
+#include <async/function/fwd.h>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace async{
+	namespace details{
+		/**
+		 * The operations of a type-erased callable
+		 * @tparam R - The return type of the callable
+		 * @tparam Args - The types of the arguments of the callable
+		 */
+		template <class R, class... Args>
+		struct callable_vtable{
+			R (*invoke)(void* storage, Args&&... args);///< @property invoke being the function that calls the stored callable
+			void (*move)(void* to, void* from);///< @property move being the function that moves the stored callable into new storage (and destroys the old one)
+			void (*destroy)(void* storage);///< @property destroy being the function that destroys the stored callable
+		};
+
+		/**
+		 * The operations of a callable stored inline
+		 * @tparam F - The type of the callable
+		 */
+		template <class F, class R, class... Args>
+		struct inplace_callable{
+			static R invoke(void* storage, Args&&... args);
+			static void move(void* to, void* from);
+			static void destroy(void* storage);
+			static const callable_vtable<R, Args...> vtable;
+		};
+
+		/**
+		 * The operations of a callable that did not fit inline (only a pointer to it is stored)
+		 * @tparam F - The type of the callable
+		 */
+		template <class F, class R, class... Args>
+		struct heap_callable{
+			static R invoke(void* storage, Args&&... args);
+			static void move(void* to, void* from);
+			static void destroy(void* storage);
+			static const callable_vtable<R, Args...> vtable;
+		};
+	}
+}
+
+/**
+ * A move-only function wrapper that stores its callable inline, without allocating
+ * @tparam R - The return type of the function
+ * @tparam Args - The types of the arguments of the function
+ * @tparam Capacity - The amount of bytes available to store the callable
+ *
+ * @warning Callables bigger than Capacity are heap allocated, or rejected at compile time when ASYNC_INPLACE_FUNCTION_NO_HEAP is defined
+ */
+template <class R, class... Args, std::size_t Capacity>
+class async::inplace_function<R(Args...), Capacity>{
+	public:
+		using result_type = R;///< @typedef result_type being the return type of the function
+		using storage_type = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;///< @typedef storage_type being the storage of the callable
+		using vtable_type = async::details::callable_vtable<R, Args...>;///< @typedef vtable_type being the type of the operations on the callable
+
+		/**
+		 * Determine whether a callable is stored inline (it must fit and be moved without throwing)
+		 * @tparam F - The type of the callable
+		 */
+		template <class F>
+		using fits = std::integral_constant<bool, sizeof(F) <= Capacity && alignof(storage_type) % alignof(F) == 0 && std::is_nothrow_move_constructible<F>::value>;
+
+		static constexpr std::size_t capacity = Capacity;///< @property capacity being the amount of bytes available to store the callable
+
+	protected:
+		const vtable_type* vtable;///< @property vtable being the operations on the stored callable (nullptr if empty)
+		mutable storage_type storage;///< @property storage being the storage of the callable
+
+		template <class F>
+		void store(F&& callable, std::true_type);
+
+		template <class F>
+		void store(F&& callable, std::false_type);
+
+	public:
+		/**
+		 * Construct an empty function
+		 */
+		inplace_function() noexcept : vtable{nullptr}{}
+		inplace_function(std::nullptr_t) noexcept : inplace_function(){}
+
+		/**
+		 * Construct a function from a callable
+		 * @tparam F - F :: (Args...) -> R
+		 * @param callable being the callable to wrap
+		 */
+		template <class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, inplace_function>::value>::type>
+		inplace_function(F&& callable);
+
+		inplace_function(inplace_function&& other) noexcept;
+		inplace_function& operator=(inplace_function&& other) noexcept;
+
+		inplace_function(const inplace_function&) = delete;
+		inplace_function& operator=(const inplace_function&) = delete;
+
+		/**
+		 * Destructor
+		 */
+		~inplace_function();
+
+		/**
+		 * Call the stored callable
+		 * @param args being the arguments to call it with
+		 * @return the result of the call
+		 * @throws std::bad_function_call if this function is empty
+		 */
+		R operator()(Args... args) const;
+
+		/**
+		 * Determine whether a callable is stored
+		 * @return TRUE if a callable is stored, FALSE otherwise
+		 */
+		explicit operator bool() const noexcept{ return this->vtable != nullptr; }
+};
@@ -0,0 +1,4 @@
+#pragma once
+#include <async/function/fwd.h>
+#include <async/function/decl.h>
+#include <async/function/impl.h>
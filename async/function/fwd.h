@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @def ASYNC_INPLACE_FUNCTION_CAPACITY
+ * The default amount of bytes a async::inplace_function stores its callable in
+ */
+#ifndef ASYNC_INPLACE_FUNCTION_CAPACITY
+#define ASYNC_INPLACE_FUNCTION_CAPACITY 64
+#endif
+
+/**
+ * @def ASYNC_INPLACE_FUNCTION_NO_HEAP
+ * When defined, a callable that does not fit in a async::inplace_function is a compile error instead of being heap allocated
+ * (opt-in, in any build type: it is meant to find the listeners that allocate, not to make release builds reject them)
+ */
+
+namespace async{
+	template <class Signature, std::size_t Capacity = ASYNC_INPLACE_FUNCTION_CAPACITY>
+	class inplace_function;
+}
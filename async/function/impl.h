@@ -0,0 +1,130 @@
+#pragma once
+#include <async/function/decl.h>
+#include <functional>
+#include <new>
+
+#define TPL template <class F, class R, class... Args>
+#define self async::details::inplace_callable<F, R, Args...>
+
+TPL
+R self::invoke(void* storage, Args&&... args){
+	return static_cast<R>((*static_cast<F*>(storage))(std::forward<Args>(args)...));
+}
+
+TPL
+void self::move(void* to, void* from){
+	auto* callable = static_cast<F*>(from);
+	new(to) F(std::move(*callable));
+	callable->~F();
+}
+
+TPL
+void self::destroy(void* storage){
+	static_cast<F*>(storage)->~F();
+}
+
+TPL
+const async::details::callable_vtable<R, Args...> self::vtable = {&self::invoke, &self::move, &self::destroy};
+
+#undef self
+
+
+#define self async::details::heap_callable<F, R, Args...>
+
+TPL
+R self::invoke(void* storage, Args&&... args){
+	return static_cast<R>((**static_cast<F**>(storage))(std::forward<Args>(args)...));
+}
+
+TPL
+void self::move(void* to, void* from){
+	new(to) F*(*static_cast<F**>(from));
+}
+
+TPL
+void self::destroy(void* storage){
+	delete *static_cast<F**>(storage);
+}
+
+TPL
+const async::details::callable_vtable<R, Args...> self::vtable = {&self::invoke, &self::move, &self::destroy};
+
+#undef TPL
+#undef self
+
+
+#define TPL template <class R, class... Args, std::size_t Capacity>
+#define constructor inplace_function
+#define self async::inplace_function<R(Args...), Capacity>
+#define self_t typename self
+
+TPL
+template <class F, class>
+self::constructor(F&& callable) : vtable{nullptr}{
+	using callable_type = typename std::decay<F>::type;
+
+#ifdef ASYNC_INPLACE_FUNCTION_NO_HEAP
+	static_assert(self::template fits<callable_type>::value, "The callable does not fit in the inplace_function (increase its capacity or reduce its captures)");
+#endif
+
+	this->store(std::forward<F>(callable), self::template fits<callable_type>{});
+}
+
+TPL
+template <class F>
+void self::store(F&& callable, std::true_type){
+	using callable_type = typename std::decay<F>::type;
+	new(&this->storage) callable_type(std::forward<F>(callable));
+	this->vtable = &async::details::inplace_callable<callable_type, R, Args...>::vtable;
+}
+
+TPL
+template <class F>
+void self::store(F&& callable, std::false_type){
+	using callable_type = typename std::decay<F>::type;
+	new(&this->storage) callable_type*(new callable_type(std::forward<F>(callable)));
+	this->vtable = &async::details::heap_callable<callable_type, R, Args...>::vtable;
+}
+
+TPL
+self::constructor(self&& other) noexcept : vtable{other.vtable}{
+	if(this->vtable)
+		this->vtable->move(&this->storage, &other.storage);
+
+	other.vtable = nullptr;
+}
+
+TPL
+self& self::operator=(self&& other) noexcept{
+	if(this == &other)
+		return *this;
+
+	if(this->vtable)
+		this->vtable->destroy(&this->storage);
+
+	this->vtable = other.vtable;
+	if(this->vtable)
+		this->vtable->move(&this->storage, &other.storage);
+
+	other.vtable = nullptr;
+	return *this;
+}
+
+TPL
+self::~constructor(){
+	if(this->vtable)
+		this->vtable->destroy(&this->storage);
+}
+
+TPL
+R self::operator()(Args... args) const{
+	if(!this->vtable)
+		throw std::bad_function_call{};
+
+	return this->vtable->invoke(&this->storage, std::forward<Args>(args)...);
+}
+
+#undef TPL
+#undef constructor
+#undef self
+#undef self_t
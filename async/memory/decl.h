@@ -0,0 +1,173 @@
+#pragma once
+#include <async/memory/fwd.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Where memory comes from (the C++11 counterpart of std::pmr::memory_resource)
+ */
+class async::memory_resource{
+	public:
+		/**
+		 * @property DEFAULT_ALIGNMENT The alignment used when none is given
+		 */
+		static constexpr std::size_t DEFAULT_ALIGNMENT = alignof(std::max_align_t);
+
+		virtual ~memory_resource() = default;
+
+		/**
+		 * Allocate memory
+		 * @param bytes being the size of the memory to allocate
+		 * @param alignment being the alignment of the memory to allocate (a power of two)
+		 * @return a pointer to the allocated memory
+		 * @throws std::bad_alloc if the memory cannot be allocated
+		 */
+		void* allocate(std::size_t bytes, std::size_t alignment = DEFAULT_ALIGNMENT){ return this->do_allocate(bytes, alignment); }
+
+		/**
+		 * Give back memory allocated by this resource
+		 * @param pointer being the memory to give back
+		 * @param bytes being the size it has been allocated with
+		 * @param alignment being the alignment it has been allocated with
+		 */
+		void deallocate(void* pointer, std::size_t bytes, std::size_t alignment = DEFAULT_ALIGNMENT){ this->do_deallocate(pointer, bytes, alignment); }
+
+		/**
+		 * Determine whether or not memory allocated by this resource can be given back to the other one and vice versa
+		 * @param other being the other resource
+		 * @return TRUE if they are interchangeable, FALSE otherwise
+		 */
+		bool is_equal(const memory_resource& other) const noexcept{ return this == &other || this->do_is_equal(other); }
+
+	protected:
+		virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+		virtual void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) = 0;
+		virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+/**
+ * A thread-safe pool of fixed-size blocks: small allocations are served from free lists refilled by chunks of the upstream
+ * resource, given back blocks are reused and the chunks are only released with the pool. Once warm, a pipeline whose values
+ * come from a pool does not touch the global heap for them.
+ */
+class async::pool_resource : public async::memory_resource{
+	public:
+		/**
+		 * @property GRANULARITY The size classes are multiples of this size (and blocks are aligned on it)
+		 */
+		static constexpr std::size_t GRANULARITY = 16;
+
+		/**
+		 * @property DEFAULT_MAX_BLOCK The default size of the largest block served by the pool
+		 */
+		static constexpr std::size_t DEFAULT_MAX_BLOCK = 4096;
+
+		/**
+		 * @property CHUNK_SIZE The size of the chunks requested to the upstream resource (at least 8 blocks)
+		 */
+		static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+	protected:
+		/**
+		 * A free block, linked to the next one
+		 */
+		struct free_block{
+			free_block* next; ///< @property next being the next free block (or nullptr)
+		};
+
+		/**
+		 * The blocks of a given size
+		 */
+		struct size_class{
+			std::mutex mutex{}; ///< @property mutex being the mutex used to lock the free list
+			free_block* free = nullptr; ///< @property free being the first free block
+			std::vector<std::pair<void*, std::size_t>> chunks{}; ///< @property chunks being the chunks the blocks have been carved from
+		};
+
+		async::shared_resource upstream; ///< @property upstream being where the chunks and the large blocks come from
+		std::size_t maxBlock; ///< @property maxBlock being the size of the largest block served by the pool
+		std::vector<std::unique_ptr<size_class>> classes; ///< @property classes being the size classes, one per multiple of GRANULARITY
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const memory_resource& other) const noexcept override{ return this == &other; }
+
+		/**
+		 * Carve a new chunk into free blocks
+		 * @param blocks being the size class to refill (locked)
+		 * @param size being the size of its blocks
+		 */
+		void refill(size_class& blocks, std::size_t size);
+
+	public:
+		/**
+		 * Construct an empty pool
+		 * @param maxBlock being the size of the largest block served by the pool (larger ones come from upstream)
+		 * @param upstream being where the memory comes from (nullptr means async::new_delete_resource)
+		 */
+		explicit pool_resource(std::size_t maxBlock = DEFAULT_MAX_BLOCK, async::shared_resource upstream = nullptr);
+
+		pool_resource(const pool_resource&) = delete;
+		pool_resource& operator=(const pool_resource&) = delete;
+
+		/**
+		 * Destructor, gives the chunks back to the upstream resource
+		 * @warning every block must have been given back (or be unused from now on)
+		 */
+		~pool_resource();
+};
+
+/**
+ * An allocator that gets its memory from a resource, and keeps the resource alive as long as what it allocated
+ * @tparam T - The type of values allocated
+ */
+template <class T>
+class async::resource_allocator{
+	template <class>
+	friend class async::resource_allocator;
+
+	public:
+		using value_type = T; ///< @typedef value_type being the type of values allocated
+
+	protected:
+		async::shared_resource resource; ///< @property resource being where the memory comes from
+
+	public:
+		/**
+		 * Construct an allocator from its resource
+		 * @param resource being where the memory comes from (nullptr means async::new_delete_resource)
+		 */
+		resource_allocator(async::shared_resource resource = nullptr);
+
+		/**
+		 * Rebinding constructor
+		 * @param other being the allocator to share the resource of
+		 */
+		template <class U>
+		resource_allocator(const resource_allocator<U>& other) : resource{other.resource}{}
+
+		T* allocate(std::size_t count){ return static_cast<T*>(this->resource->allocate(count * sizeof(T), alignof(T))); }
+		void deallocate(T* pointer, std::size_t count){ this->resource->deallocate(pointer, count * sizeof(T), alignof(T)); }
+
+		/**
+		 * Get the resource of this allocator
+		 * @return the resource the memory comes from
+		 */
+		const async::shared_resource& get_resource() const{ return this->resource; }
+
+		template <class U>
+		bool operator==(const resource_allocator<U>& other) const{ return this->resource->is_equal(*other.resource); }
+
+		template <class U>
+		bool operator!=(const resource_allocator<U>& other) const{ return !(*this == other); }
+};
+
+namespace async{
+	/**
+	 * Get the resource that uses the global operator new and operator delete
+	 * @return the process wide resource (not reference counted)
+	 */
+	inline async::shared_resource new_delete_resource();
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <memory>
+
+namespace async{
+	class memory_resource;
+	class pool_resource;
+
+	template <class T>
+	class resource_allocator;
+
+	using shared_resource = std::shared_ptr<memory_resource>;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <async/memory/decl.h>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace async{
+	namespace details{
+		/**
+		 * The resource that uses the global operator new and operator delete (over-aligned blocks are aligned by hand)
+		 */
+		class new_delete_resource_type final : public async::memory_resource{
+			protected:
+				void* do_allocate(std::size_t bytes, std::size_t alignment) override{
+					if(alignment <= DEFAULT_ALIGNMENT)
+						return ::operator new(bytes);
+
+					//Room to align the block and to remember where the allocation starts
+					auto* raw = static_cast<char*>(::operator new(bytes + alignment + sizeof(void*)));
+					const auto address = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+					auto* aligned = reinterpret_cast<char*>((address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+					reinterpret_cast<void**>(aligned)[-1] = raw;
+					return aligned;
+				}
+
+				void do_deallocate(void* pointer, std::size_t, std::size_t alignment) override{
+					if(alignment <= DEFAULT_ALIGNMENT)
+						::operator delete(pointer);
+					else
+						::operator delete(static_cast<void**>(pointer)[-1]);
+				}
+
+				bool do_is_equal(const memory_resource& other) const noexcept override{
+					return dynamic_cast<const new_delete_resource_type*>(&other) != nullptr;
+				}
+		};
+	}
+}
+
+inline async::shared_resource async::new_delete_resource(){
+	static async::details::new_delete_resource_type resource;
+
+	//Aliases nothing: copies do not touch a reference count
+	return async::shared_resource{async::shared_resource{}, &resource};
+}
+
+
+#define self async::pool_resource
+#define constructor pool_resource
+
+inline self::constructor(std::size_t maxBlock, async::shared_resource upstream)
+: upstream{upstream ? std::move(upstream) : async::new_delete_resource()}, maxBlock{(maxBlock + GRANULARITY - 1) / GRANULARITY * GRANULARITY}{
+	this->classes.reserve(this->maxBlock / GRANULARITY);
+	for(std::size_t i = 0 ; i < this->maxBlock / GRANULARITY ; ++i)
+		this->classes.emplace_back(new size_class{});
+}
+
+inline self::~constructor(){
+	for(const auto& blocks : this->classes){
+		for(const auto& chunk : blocks->chunks)
+			this->upstream->deallocate(chunk.first, chunk.second, GRANULARITY);
+	}
+}
+
+inline void self::refill(size_class& blocks, std::size_t size){
+	std::size_t bytes = CHUNK_SIZE;
+	if(size * 8 > bytes)
+		bytes = size * 8;
+	auto* chunk = static_cast<char*>(this->upstream->allocate(bytes, GRANULARITY));
+	blocks.chunks.emplace_back(chunk, bytes);
+
+	for(std::size_t offset = 0 ; offset + size <= bytes ; offset += size){
+		auto* block = reinterpret_cast<free_block*>(chunk + offset);
+		block->next = blocks.free;
+		blocks.free = block;
+	}
+}
+
+inline void* self::do_allocate(std::size_t bytes, std::size_t alignment){
+	if(bytes == 0)
+		bytes = 1;
+
+	if(bytes > this->maxBlock || alignment > GRANULARITY)
+		return this->upstream->allocate(bytes, alignment);
+
+	const auto index = (bytes - 1) / GRANULARITY;
+	auto& blocks = *this->classes[index];
+	std::lock_guard<std::mutex> _{blocks.mutex};
+
+	if(!blocks.free)
+		this->refill(blocks, (index + 1) * GRANULARITY);
+
+	auto* block = blocks.free;
+	blocks.free = block->next;
+	return block;
+}
+
+inline void self::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment){
+	if(bytes == 0)
+		bytes = 1;
+
+	if(bytes > this->maxBlock || alignment > GRANULARITY)
+		return this->upstream->deallocate(pointer, bytes, alignment);
+
+	auto& blocks = *this->classes[(bytes - 1) / GRANULARITY];
+	std::lock_guard<std::mutex> _{blocks.mutex};
+
+	auto* block = static_cast<free_block*>(pointer);
+	block->next = blocks.free;
+	blocks.free = block;
+}
+
+#undef self
+#undef constructor
+
+
+template <class T>
+async::resource_allocator<T>::resource_allocator(async::shared_resource resource)
+: resource{resource ? std::move(resource) : async::new_delete_resource()}{
+}
@@ -0,0 +1,4 @@
+#pragma once
+#include <async/memory/fwd.h>
+#include <async/memory/decl.h>
+#include <async/memory/impl.h>
@@ -0,0 +1,188 @@
+#pragma once
+#include <async/metrics/fwd.h>
+#include <async/queue/decl.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace async{
+	namespace metrics{
+		/**
+		 * Get the current time of the clock used by the metrics
+		 * @return the amount of nanoseconds elapsed since the epoch of std::chrono::steady_clock
+		 */
+		inline std::uint64_t now();
+	}
+}
+
+/**
+ * A counter incremented from many threads: each thread adds to its own shard (relaxed), reads sum the shards up
+ */
+class async::metrics::counter{
+	public:
+		/**
+		 * @property SHARDS The amount of shards of a counter
+		 */
+		static constexpr std::size_t SHARDS = 16;
+
+	protected:
+		/**
+		 * A shard of the counter, on its own cache line
+		 */
+		struct shard{
+			std::atomic<std::uint64_t> value{0}; ///< @property value being the sum of what has been added to this shard
+			char padding[async::cache_line_size - sizeof(std::atomic<std::uint64_t>)]; ///< @property padding keeps the shards apart
+		};
+
+		shard shards[SHARDS]; ///< @property shards being the shards of the counter
+
+		/**
+		 * Get the index of the shard the calling thread adds to
+		 * @return the index of the shard of the calling thread
+		 */
+		static std::size_t shard_index();
+
+	public:
+		counter() = default;
+		counter(const counter&) = delete;
+		counter& operator=(const counter&) = delete;
+
+		/**
+		 * Add to the counter
+		 * @param amount being the amount to add
+		 */
+		void add(std::uint64_t amount = 1){ this->shards[counter::shard_index()].value.fetch_add(amount, std::memory_order_relaxed); }
+
+		/**
+		 * Read the counter
+		 * @return the sum of the shards (not a consistent snapshot if the counter is being added to)
+		 */
+		std::uint64_t load() const;
+};
+
+/**
+ * A snapshot of a latency histogram
+ */
+struct async::metrics::histogram_snapshot{
+	std::uint64_t count = 0; ///< @property count being the amount of recorded values
+	std::uint64_t sum = 0; ///< @property sum being the sum of the recorded values
+	std::uint64_t max = 0; ///< @property max being the largest recorded value
+	std::vector<std::uint64_t> buckets{}; ///< @property buckets being the amount of values recorded in each bucket
+
+	/**
+	 * Get the mean of the recorded values
+	 * @return the mean (0 if nothing has been recorded)
+	 */
+	double mean() const{ return this->count == 0 ? 0 : static_cast<double>(this->sum) / this->count; }
+
+	/**
+	 * Get the value below which the given percentage of the recorded values fall
+	 * @param p being the percentage (eg. 99.9)
+	 * @return the largest value of the bucket the percentile falls into (0 if nothing has been recorded)
+	 */
+	std::uint64_t percentile(double p) const;
+};
+
+/**
+ * A histogram of latencies (in nanoseconds) with a bounded relative error, HDR-style: each power of two is split into
+ * SUB_BUCKETS linear buckets (about 6% of error), values are recorded with a single relaxed increment
+ */
+class async::metrics::histogram{
+	public:
+		/**
+		 * @property SUB_BUCKET_BITS The log2 of the amount of buckets per power of two
+		 */
+		static constexpr std::size_t SUB_BUCKET_BITS = 4;
+
+		/**
+		 * @property SUB_BUCKETS The amount of buckets per power of two
+		 */
+		static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BUCKET_BITS;
+
+		/**
+		 * @property BUCKETS The amount of buckets needed to cover 64 bits values
+		 */
+		static constexpr std::size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	protected:
+		std::atomic<std::uint64_t> buckets[BUCKETS]; ///< @property buckets being the amount of values recorded in each bucket
+		async::metrics::counter sum{}; ///< @property sum being the sum of the recorded values
+		std::atomic<std::uint64_t> max{0}; ///< @property max being the largest recorded value
+
+	public:
+		histogram();
+		histogram(const histogram&) = delete;
+		histogram& operator=(const histogram&) = delete;
+
+		/**
+		 * Record a value
+		 * @param value being the value to record
+		 */
+		void record(std::uint64_t value);
+
+		/**
+		 * Take a snapshot of this histogram
+		 * @return the recorded values so far
+		 */
+		async::metrics::histogram_snapshot snapshot() const;
+
+		/**
+		 * Get the bucket a value is recorded in
+		 * @param value being the value
+		 * @return the index of its bucket
+		 */
+		static std::size_t bucket_of(std::uint64_t value);
+
+		/**
+		 * Get the largest value recorded in a bucket
+		 * @param bucket being the index of the bucket
+		 * @return the largest value that goes to that bucket
+		 */
+		static std::uint64_t highest_of(std::size_t bucket);
+};
+
+/**
+ * A snapshot of the metrics of a listener
+ */
+struct async::metrics::listener_snapshot{
+	std::size_t id = 0; ///< @property id being the subscription of the listener
+	std::uint64_t invocations = 0; ///< @property invocations being the amount of values or batches handed to the listener
+	async::metrics::histogram_snapshot duration{}; ///< @property duration being how long the listener took for each of them (ns)
+};
+
+/**
+ * A snapshot of the metrics of a stream
+ */
+struct async::metrics::stream_snapshot{
+	std::uint64_t emitted = 0; ///< @property emitted being the amount of values emitted (including the dropped ones)
+	std::uint64_t delivered = 0; ///< @property delivered being the amount of values handed to the listeners
+	std::uint64_t dropped = 0; ///< @property dropped being the amount of values discarded because the queue was full
+	std::uint64_t blocked = 0; ///< @property blocked being the amount of emits that had to wait for room in the queue
+	std::size_t depth = 0; ///< @property depth being the amount of values awaiting delivery
+	std::size_t maxDepth = 0; ///< @property maxDepth being the largest depth seen by a delivery
+	std::size_t capacity = 0; ///< @property capacity being the capacity of the queue
+	async::metrics::histogram_snapshot dispatch{}; ///< @property dispatch being the time values spent in the queue (ns)
+	std::vector<async::metrics::listener_snapshot> listeners{}; ///< @property listeners being the metrics of the listeners
+};
+
+namespace async{
+	namespace metrics{
+		/**
+		 * Print a histogram as its count, mean and percentiles
+		 * @param out being the stream to print to
+		 * @param histogram being the histogram to print
+		 * @return out
+		 */
+		inline std::ostream& operator<<(std::ostream& out, const async::metrics::histogram_snapshot& histogram);
+
+		/**
+		 * Print the metrics of a stream, one line for the stream and one per listener
+		 * @param out being the stream to print to
+		 * @param stream being the metrics to print
+		 * @return out
+		 */
+		inline std::ostream& operator<<(std::ostream& out, const async::metrics::stream_snapshot& stream);
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace async{
+	/**
+	 * @namespace async::metrics
+	 * Counters and latency histograms used to instrument streams (see ASYNC_STREAM_METRICS)
+	 */
+	namespace metrics{
+		class counter;
+		class histogram;
+		struct histogram_snapshot;
+		struct listener_snapshot;
+		struct stream_snapshot;
+	}
+}
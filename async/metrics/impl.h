@@ -0,0 +1,127 @@
+#pragma once
+#include <async/metrics/decl.h>
+#include <chrono>
+#include <ostream>
+
+inline std::uint64_t async::metrics::now(){
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()
+	).count());
+}
+
+
+#define self async::metrics::counter
+
+inline std::size_t self::shard_index(){
+	static std::atomic<std::size_t> next{0};
+	static thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % self::SHARDS;
+	return index;
+}
+
+inline std::uint64_t self::load() const{
+	std::uint64_t total = 0;
+	for(const auto& shard : this->shards)
+		total += shard.value.load(std::memory_order_relaxed);
+
+	return total;
+}
+
+#undef self
+
+
+inline std::uint64_t async::metrics::histogram_snapshot::percentile(double p) const{
+	if(this->count == 0)
+		return 0;
+
+	const auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(this->count - 1)) + 1;
+	std::uint64_t seen = 0;
+
+	for(std::size_t bucket = 0 ; bucket < this->buckets.size() ; ++bucket){
+		seen += this->buckets[bucket];
+		if(seen >= rank){
+			const auto highest = async::metrics::histogram::highest_of(bucket);
+			return highest < this->max ? highest : this->max;
+		}
+	}
+
+	return this->max;
+}
+
+
+#define self async::metrics::histogram
+#define constructor histogram
+
+inline self::constructor(){
+	for(auto& bucket : this->buckets)
+		bucket.store(0, std::memory_order_relaxed);
+}
+
+inline std::size_t self::bucket_of(std::uint64_t value){
+	if(value < self::SUB_BUCKETS)
+		return static_cast<std::size_t>(value);
+
+	//value is in [2^msb, 2^(msb + 1)), split in SUB_BUCKETS linear buckets
+	const std::size_t msb = 63 - static_cast<std::size_t>(__builtin_clzll(value));
+	const std::size_t shift = msb - self::SUB_BUCKET_BITS;
+	return (shift + 1) * self::SUB_BUCKETS + static_cast<std::size_t>(value >> shift) - self::SUB_BUCKETS;
+}
+
+inline std::uint64_t self::highest_of(std::size_t bucket){
+	if(bucket < self::SUB_BUCKETS)
+		return bucket;
+
+	const std::size_t shift = bucket / self::SUB_BUCKETS - 1;
+	const std::uint64_t sub = bucket % self::SUB_BUCKETS + self::SUB_BUCKETS;
+	return ((sub + 1) << shift) - 1;
+}
+
+inline void self::record(std::uint64_t value){
+	this->buckets[self::bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+	this->sum.add(value);
+
+	auto max = this->max.load(std::memory_order_relaxed);
+	while(value > max && !this->max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+inline async::metrics::histogram_snapshot self::snapshot() const{
+	async::metrics::histogram_snapshot snapshot;
+	snapshot.buckets.reserve(self::BUCKETS);
+
+	for(const auto& bucket : this->buckets){
+		const auto count = bucket.load(std::memory_order_relaxed);
+		snapshot.buckets.push_back(count);
+		snapshot.count += count;
+	}
+
+	snapshot.sum = this->sum.load();
+	snapshot.max = this->max.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+#undef self
+#undef constructor
+
+
+inline std::ostream& async::metrics::operator<<(std::ostream& out, const async::metrics::histogram_snapshot& histogram){
+	return out << "count=" << histogram.count
+		<< " mean=" << static_cast<std::uint64_t>(histogram.mean()) << "ns"
+		<< " p50=" << histogram.percentile(50) << "ns"
+		<< " p99=" << histogram.percentile(99) << "ns"
+		<< " p999=" << histogram.percentile(99.9) << "ns"
+		<< " max=" << histogram.max << "ns";
+}
+
+inline std::ostream& async::metrics::operator<<(std::ostream& out, const async::metrics::stream_snapshot& stream){
+	out << "emitted=" << stream.emitted
+		<< " delivered=" << stream.delivered
+		<< " dropped=" << stream.dropped
+		<< " blocked=" << stream.blocked
+		<< " depth=" << stream.depth << '/' << stream.capacity
+		<< " maxDepth=" << stream.maxDepth << '\n'
+		<< "  dispatch: " << stream.dispatch << '\n';
+
+	for(const auto& listener : stream.listeners)
+		out << "  listener #" << listener.id << ": " << listener.duration << '\n';
+
+	return out;
+}
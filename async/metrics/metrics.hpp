@@ -0,0 +1,4 @@
+#pragma once
+#include <async/metrics/fwd.h>
+#include <async/metrics/decl.h>
+#include <async/metrics/impl.h>
@@ -0,0 +1,300 @@
+#pragma once
+#include <async/pipeline/fwd.h>
+#include <async/stream/fwd.h>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+/**
+ * @namespace async::fused
+ * The stages of a pipeline, each one wraps the sink of the next stage so that the whole chain compiles down to nested inlined calls
+ */
+namespace async{
+	namespace fused{
+		/**
+		 * Holds the functor of a stage, as a base class when it is empty (eg. a lambda without captures) so that it takes no room
+		 * @tparam F - The type of functor
+		 */
+		template <class F, bool = std::is_empty<F>::value && !__is_final(F)>
+		class functor_holder : private F{
+			public:
+				explicit functor_holder(F functor) : F(std::move(functor)){}
+
+			protected:
+				/**
+				 * Get the functor
+				 * @return a reference to the functor
+				 */
+				F& functor(){ return *this; }
+		};
+
+		template <class F>
+		class functor_holder<F, false>{
+			protected:
+				F held;///< @property held being the functor
+
+			public:
+				explicit functor_holder(F functor) : held(std::move(functor)){}
+
+			protected:
+				/**
+				 * Get the functor
+				 * @return a reference to the functor
+				 */
+				F& functor(){ return this->held; }
+		};
+
+		/**
+		 * The sink of a filter stage, forwards the values that match the predicate
+		 * @tparam Predicate - Predicate :: (const V&) -> bool
+		 * @tparam Sink - The sink of the next stage
+		 */
+		template <class Predicate, class Sink>
+		struct filter_sink : functor_holder<Predicate>{
+			Sink sink;///< @property sink being the sink of the next stage
+
+			/**
+			 * @param predicate being the predicate values must match
+			 * @param sink being the sink of the next stage
+			 */
+			filter_sink(Predicate predicate, Sink sink) : functor_holder<Predicate>{std::move(predicate)}, sink(std::move(sink)){}
+
+			template <class V>
+			void operator()(const V& value){
+				if(this->functor()(value))
+					this->sink(value);
+			}
+		};
+
+		/**
+		 * The sink of a map stage, forwards the mapped values
+		 * @tparam U - The type of the mapped values
+		 * @tparam Mapper - Mapper :: (const V&) -> U
+		 * @tparam Sink - The sink of the next stage
+		 */
+		template <class U, class Mapper, class Sink>
+		struct map_sink : functor_holder<Mapper>{
+			Sink sink;///< @property sink being the sink of the next stage
+
+			/**
+			 * @param mapper being the function used to map each value
+			 * @param sink being the sink of the next stage
+			 */
+			map_sink(Mapper mapper, Sink sink) : functor_holder<Mapper>{std::move(mapper)}, sink(std::move(sink)){}
+
+			template <class V>
+			void operator()(const V& value){
+				const U& mapped = this->functor()(value);
+				this->sink(mapped);
+			}
+		};
+
+		/**
+		 * The sink of a filterMap stage, forwards the values the parser could map
+		 * @tparam U - The type of the mapped values
+		 * @tparam Parser - Parser :: (const V&, U&) -> bool
+		 * @tparam Sink - The sink of the next stage
+		 */
+		template <class U, class Parser, class Sink>
+		struct filter_map_sink : functor_holder<Parser>{
+			Sink sink;///< @property sink being the sink of the next stage
+
+			/**
+			 * @param parser being the function used to map each value
+			 * @param sink being the sink of the next stage
+			 */
+			filter_map_sink(Parser parser, Sink sink) : functor_holder<Parser>{std::move(parser)}, sink(std::move(sink)){}
+
+			template <class V>
+			void operator()(const V& value){
+				U mapped;
+				if(this->functor()(value, mapped))
+					this->sink(static_cast<const U&>(mapped));
+			}
+		};
+
+		/**
+		 * The sink of a peek stage, shows every value to the consumer before forwarding it
+		 * @tparam Consumer - Consumer :: (const V&) -> void
+		 * @tparam Sink - The sink of the next stage
+		 */
+		template <class Consumer, class Sink>
+		struct peek_sink : functor_holder<Consumer>{
+			Sink sink;///< @property sink being the sink of the next stage
+
+			/**
+			 * @param consumer being the function invoked on each value
+			 * @param sink being the sink of the next stage
+			 */
+			peek_sink(Consumer consumer, Sink sink) : functor_holder<Consumer>{std::move(consumer)}, sink(std::move(sink)){}
+
+			template <class V>
+			void operator()(const V& value){
+				this->functor()(value);
+				this->sink(value);
+			}
+		};
+
+		/**
+		 * The empty chain of stages
+		 */
+		struct identity{
+			template <class Sink>
+			Sink wrap(Sink sink) const{ return sink; }
+		};
+
+		/**
+		 * A filter appended to a chain of stages
+		 * @tparam Stages - The stages that come before
+		 * @tparam Predicate - Predicate :: (const V&) -> bool
+		 */
+		template <class Stages, class Predicate>
+		struct filter_stage{
+			Stages stages;///< @property stages being the stages that come before
+			Predicate predicate;///< @property predicate being the predicate values must match
+
+			template <class Sink>
+			auto wrap(Sink sink) const -> decltype(std::declval<const Stages&>().wrap(std::declval<filter_sink<Predicate, Sink>>())){
+				return this->stages.wrap(filter_sink<Predicate, Sink>{this->predicate, std::move(sink)});
+			}
+		};
+
+		/**
+		 * A map appended to a chain of stages
+		 * @tparam Stages - The stages that come before
+		 * @tparam U - The type of the mapped values
+		 * @tparam Mapper - Mapper :: (const V&) -> U
+		 */
+		template <class Stages, class U, class Mapper>
+		struct map_stage{
+			Stages stages;///< @property stages being the stages that come before
+			Mapper mapper;///< @property mapper being the function used to map each value
+
+			template <class Sink>
+			auto wrap(Sink sink) const -> decltype(std::declval<const Stages&>().wrap(std::declval<map_sink<U, Mapper, Sink>>())){
+				return this->stages.wrap(map_sink<U, Mapper, Sink>{this->mapper, std::move(sink)});
+			}
+		};
+
+		/**
+		 * A filterMap appended to a chain of stages
+		 * @tparam Stages - The stages that come before
+		 * @tparam U - The type of the mapped values
+		 * @tparam Parser - Parser :: (const V&, U&) -> bool
+		 */
+		template <class Stages, class U, class Parser>
+		struct filter_map_stage{
+			Stages stages;///< @property stages being the stages that come before
+			Parser parser;///< @property parser being the function used to map each value
+
+			template <class Sink>
+			auto wrap(Sink sink) const -> decltype(std::declval<const Stages&>().wrap(std::declval<filter_map_sink<U, Parser, Sink>>())){
+				return this->stages.wrap(filter_map_sink<U, Parser, Sink>{this->parser, std::move(sink)});
+			}
+		};
+
+		/**
+		 * A peek appended to a chain of stages
+		 * @tparam Stages - The stages that come before
+		 * @tparam Consumer - Consumer :: (const V&) -> void
+		 */
+		template <class Stages, class Consumer>
+		struct peek_stage{
+			Stages stages;///< @property stages being the stages that come before
+			Consumer consumer;///< @property consumer being the function invoked on each value
+
+			template <class Sink>
+			auto wrap(Sink sink) const -> decltype(std::declval<const Stages&>().wrap(std::declval<peek_sink<Consumer, Sink>>())){
+				return this->stages.wrap(peek_sink<Consumer, Sink>{this->consumer, std::move(sink)});
+			}
+		};
+	}
+}
+
+/**
+ * A chain of stateless operators built at compile time and attached to a stream as a single listener
+ * @tparam Source - The type of values of the source stream
+ * @tparam T - The type of values coming out of the pipeline
+ * @tparam Stages - The chain of stages (from async::fused)
+ *
+ * @warning The source stream must outlive the pipeline until a terminal operation (forEach, stream) attaches it
+ */
+template <class Source, class T, class Stages>
+class async::pipeline{
+	public:
+		using source_type = async::stream<Source>;///< @typedef source_type being the type of the stream the pipeline listens to
+		using value_type = T;///< @typedef value_type being the type of values coming out of the pipeline
+		using stages_type = Stages;///< @typedef stages_type being the type of the chain of stages
+		using stream_type = async::stream<T>;///< @typedef stream_type being the type of stream the pipeline can be collected into
+		using shared_stream = std::shared_ptr<stream_type>;///< @typedef shared_stream being the type of shared pointer to such a stream
+
+	protected:
+		source_type* source;///< @property source being the stream the pipeline listens to
+		stages_type stages;///< @property stages being the chain of stages
+
+	public:
+		/**
+		 * Construct a pipeline
+		 * @param source being the stream to listen to
+		 * @param stages being the chain of stages
+		 */
+		pipeline(source_type* source, stages_type stages) : source{source}, stages{std::move(stages)}{}
+
+		/**
+		 * Only keep the values that match the predicate
+		 * @tparam Predicate - Predicate :: (const value_type&) -> bool
+		 * @param predicate being the predicate values must match
+		 * @return the extended pipeline
+		 */
+		template <class Predicate>
+		async::pipeline<Source, T, async::fused::filter_stage<Stages, Predicate>> filter(Predicate predicate) const;
+
+		/**
+		 * @defgroup mapping
+		 * @{
+		 * Map the values into values of another type
+		 * @tparam U - The type of the mapped values
+		 * @tparam Mapper - Mapper :: (const value_type&) -> U
+		 * @param mapper being the function used to map each value
+		 * @return the extended pipeline
+		 */
+		template <class U, class Mapper>
+		async::pipeline<Source, U, async::fused::map_stage<Stages, U, Mapper>> map(Mapper mapper) const;
+
+		template <class U, class Mapper>
+		async::pipeline<Source, U, async::fused::map_stage<Stages, U, Mapper>> mapTo(Mapper mapper) const;
+		/** @} */
+
+		/**
+		 * Map the values that can be mapped, dropping the others (eg. validate and parse)
+		 * @tparam U - The type of the mapped values
+		 * @tparam Parser - Parser :: (const value_type&, U&) -> bool
+		 * @param parser being the function that stores the mapped value in its second argument, returns false to drop the value
+		 * @return the extended pipeline
+		 */
+		template <class U, class Parser>
+		async::pipeline<Source, U, async::fused::filter_map_stage<Stages, U, Parser>> filterMap(Parser parser) const;
+
+		/**
+		 * Invoke a function on each value going through the pipeline
+		 * @tparam Consumer - Consumer :: (const value_type&) -> void
+		 * @param consumer being the function to invoke
+		 * @return the extended pipeline
+		 */
+		template <class Consumer>
+		async::pipeline<Source, T, async::fused::peek_stage<Stages, Consumer>> peek(Consumer consumer) const;
+
+		/**
+		 * Attach the pipeline to its source, ending it with the given consumer
+		 * @tparam Consumer - Consumer :: (const value_type&) -> void
+		 * @param consumer being the function to invoke on each value coming out of the pipeline
+		 */
+		template <class Consumer>
+		void forEach(Consumer consumer) const;
+
+		/**
+		 * Attach the pipeline to its source, collecting its values into a new stream (closed along with the source)
+		 * @return a shared_ptr to the stream
+		 */
+		shared_stream stream() const;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace async{
+	template <class Source, class T, class Stages>
+	class pipeline;
+
+	namespace fused{
+		struct identity;
+
+		template <class Stages, class Predicate>
+		struct filter_stage;
+
+		template <class Stages, class U, class Mapper>
+		struct map_stage;
+
+		template <class Stages, class U, class Parser>
+		struct filter_map_stage;
+
+		template <class Stages, class Consumer>
+		struct peek_stage;
+	}
+}
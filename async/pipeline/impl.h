@@ -0,0 +1,66 @@
+#pragma once
+#include <async/pipeline/decl.h>
+#include <async/stream/stream.hpp>
+
+#define TPL template <class Source, class T, class Stages>
+#define self async::pipeline<Source, T, Stages>
+#define self_t typename self
+
+TPL
+template <class Predicate>
+async::pipeline<Source, T, async::fused::filter_stage<Stages, Predicate>> self::filter(Predicate predicate) const{
+	using stage_type = async::fused::filter_stage<Stages, Predicate>;
+	return async::pipeline<Source, T, stage_type>{this->source, stage_type{this->stages, std::move(predicate)}};
+}
+
+TPL
+template <class U, class Mapper>
+async::pipeline<Source, U, async::fused::map_stage<Stages, U, Mapper>> self::map(Mapper mapper) const{
+	using stage_type = async::fused::map_stage<Stages, U, Mapper>;
+	return async::pipeline<Source, U, stage_type>{this->source, stage_type{this->stages, std::move(mapper)}};
+}
+
+TPL
+template <class U, class Mapper>
+async::pipeline<Source, U, async::fused::map_stage<Stages, U, Mapper>> self::mapTo(Mapper mapper) const{
+	return this->template map<U>(std::move(mapper));
+}
+
+TPL
+template <class U, class Parser>
+async::pipeline<Source, U, async::fused::filter_map_stage<Stages, U, Parser>> self::filterMap(Parser parser) const{
+	using stage_type = async::fused::filter_map_stage<Stages, U, Parser>;
+	return async::pipeline<Source, U, stage_type>{this->source, stage_type{this->stages, std::move(parser)}};
+}
+
+TPL
+template <class Consumer>
+async::pipeline<Source, T, async::fused::peek_stage<Stages, Consumer>> self::peek(Consumer consumer) const{
+	using stage_type = async::fused::peek_stage<Stages, Consumer>;
+	return async::pipeline<Source, T, stage_type>{this->source, stage_type{this->stages, std::move(consumer)}};
+}
+
+TPL
+template <class Consumer>
+void self::forEach(Consumer consumer) const{
+	this->source->onValue(this->stages.wrap(std::move(consumer)));
+}
+
+TPL
+self_t::shared_stream self::stream() const{
+	self_t::shared_stream collected = this->source->template derive<T>();
+
+	this->forEach([=](const value_type& value){
+		collected->emit(value);
+	});
+
+	this->source->onClose([=]{
+		collected->close();
+	});
+
+	return collected;
+}
+
+#undef TPL
+#undef self
+#undef self_t
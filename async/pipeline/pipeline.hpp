@@ -0,0 +1,4 @@
+#pragma once
+#include <async/pipeline/fwd.h>
+#include <async/pipeline/decl.h>
+#include <async/pipeline/impl.h>
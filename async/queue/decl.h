@@ -0,0 +1,309 @@
+#pragma once
+#include <async/queue/fwd.h>
+#include <async/memory/decl.h>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+
+namespace async{
+	/**
+	 * @property cache_line_size The assumed size of a cache line, used to keep concurrently written data apart
+	 */
+	constexpr std::size_t cache_line_size = 64;
+
+	namespace details{
+		/**
+		 * Hint the CPU that the calling thread is spin-waiting
+		 */
+		inline void cpu_relax();
+
+		/**
+		 * Round a capacity up to the next power of two
+		 * @param value being the capacity to round
+		 * @return the smallest power of two greater than or equal to value (at least 2)
+		 */
+		inline std::size_t next_power_of_two(std::size_t value);
+	}
+}
+
+/**
+ * The interface of the queues used to buffer the values of a stream until they are delivered
+ * @tparam T The type of values stored in the queue
+ */
+template <class T>
+class async::delivery_queue{
+	public:
+		using value_type = T; ///< @typedef value_type being the type of values stored in the queue
+
+		/**
+		 * Destructor
+		 */
+		virtual ~delivery_queue() = default;
+
+		/**
+		 * Attempt to push a value at the back of the queue
+		 * @param value being the value to push (moved from on success)
+		 * @return TRUE if the value has been pushed, FALSE if the queue is full
+		 */
+		virtual bool try_push(value_type& value) = 0;
+
+		/**
+		 * Attempt to pop the value at the front of the queue
+		 * @param storage being uninitialized storage in which the popped value is move-constructed
+		 * @return TRUE if a value has been popped (the caller then destroys it), FALSE if the queue is empty
+		 */
+		virtual bool try_pop(value_type* storage) = 0;
+
+		/**
+		 * Discard the value at the front of the queue (from the producer's side)
+		 * @return TRUE if a value has been discarded, FALSE otherwise
+		 */
+		virtual bool evict() = 0;
+
+		/**
+		 * Retrieve the amount of values currently stored
+		 * @return the amount of values in the queue (an approximation when accessed concurrently)
+		 */
+		virtual std::size_t size() const = 0;
+
+		/**
+		 * Retrieve the maximum amount of values that can be stored
+		 * @return the capacity of the queue (0 means unbounded)
+		 */
+		virtual std::size_t capacity() const = 0;
+};
+
+/**
+ * A bounded queue protected by a mutex, suited for any amount of producers
+ * @tparam T The type of values stored in the queue
+ */
+template <class T>
+class async::locked_queue : public async::delivery_queue<T>{
+	public:
+		using value_type = T; ///< @typedef value_type being the type of values stored in the queue
+		using mutex_type = std::mutex; ///< @typedef mutex_type being the type of mutex used to lock the queue
+		using lock_guard = std::lock_guard<mutex_type>; ///< @typedef lock_guard being the type of lock guard used to lock the queue
+
+	protected:
+		mutable mutex_type mutex{}; ///< @property mutex being the mutex used to lock the queue
+		std::deque<value_type, async::resource_allocator<value_type>> values; ///< @property values being the values stored in the queue
+		std::size_t max; ///< @property max being the capacity of the queue (0 means unbounded)
+
+	public:
+		/**
+		 * Construct a queue with the given capacity
+		 * @param capacity being the maximum amount of values stored at once (0 means unbounded)
+		 * @param resource being where the nodes of the queue are allocated (nullptr means async::new_delete_resource)
+		 */
+		explicit locked_queue(std::size_t capacity, async::shared_resource resource = nullptr)
+		: values{async::resource_allocator<value_type>{std::move(resource)}}, max{capacity}{}
+
+		bool try_push(value_type& value) override;
+		bool try_pop(value_type* storage) override;
+		bool evict() override;
+		std::size_t size() const override;
+		std::size_t capacity() const override{ return this->max; }
+};
+
+/**
+ * A wait-free bounded ring buffer for exactly one producer thread and one consumer thread at a time
+ * @tparam T The type of values stored in the queue
+ */
+template <class T>
+class async::spsc_queue : public async::delivery_queue<T>{
+	public:
+		using value_type = T; ///< @typedef value_type being the type of values stored in the queue
+		using index_type = std::size_t; ///< @typedef index_type being the type of the (ever increasing) positions in the ring
+		using storage_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type; ///< @typedef storage_type being the raw storage of a slot
+
+	protected:
+		const index_type mask; ///< @property mask being the mask used to map a position to a slot
+		std::unique_ptr<storage_type[]> slots; ///< @property slots being the storage of the ring
+
+		char headPadding[async::cache_line_size]; ///< @property headPadding keeps the consumer's data on its own cache line
+		std::atomic<index_type> head{0}; ///< @property head being the position of the next value to pop (written by the consumer)
+		index_type cachedTail = 0; ///< @property cachedTail being the consumer's last known value of tail
+
+		char tailPadding[async::cache_line_size]; ///< @property tailPadding keeps the producer's data on its own cache line
+		std::atomic<index_type> tail{0}; ///< @property tail being the position of the next value to push (written by the producer)
+		index_type cachedHead = 0; ///< @property cachedHead being the producer's last known value of head
+
+		char endPadding[async::cache_line_size]; ///< @property endPadding keeps the producer's data away from whatever follows
+
+		/**
+		 * Get the value stored at the given position
+		 * @param position being the position in the ring
+		 * @return a pointer to the slot
+		 */
+		value_type* at(index_type position){ return reinterpret_cast<value_type*>(&this->slots[position & this->mask]); }
+
+	public:
+		/**
+		 * Construct a queue with the given capacity
+		 * @param capacity being the minimum amount of values stored at once (rounded up to a power of two)
+		 */
+		explicit spsc_queue(std::size_t capacity);
+
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue& operator=(const spsc_queue&) = delete;
+
+		/**
+		 * Destructor, destroys the values left in the ring
+		 */
+		~spsc_queue();
+
+		bool try_push(value_type& value) override;
+		bool try_pop(value_type* storage) override;
+
+		/**
+		 * The producer cannot discard values without becoming a second consumer
+		 * @return FALSE
+		 */
+		bool evict() override{ return false; }
+
+		std::size_t size() const override;
+		std::size_t capacity() const override{ return this->mask + 1; }
+};
+
+/**
+ * A bounded lock-free ring buffer for any amount of producers and consumers, each slot carrying a sequence number
+ * @tparam T The type of values stored in the queue
+ */
+template <class T>
+class async::mpmc_queue : public async::delivery_queue<T>{
+	public:
+		using value_type = T; ///< @typedef value_type being the type of values stored in the queue
+		using index_type = std::size_t; ///< @typedef index_type being the type of the (ever increasing) positions in the ring
+		using storage_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type; ///< @typedef storage_type being the raw storage of a slot
+
+	protected:
+		/**
+		 * A slot of the ring, its sequence tells whether it is ready to be written or read for a given position
+		 */
+		struct cell{
+			std::atomic<index_type> sequence; ///< @property sequence being the position this slot is ready for
+			storage_type storage; ///< @property storage being the storage of the value
+
+			value_type* value(){ return reinterpret_cast<value_type*>(&this->storage); }
+		};
+
+		const index_type mask; ///< @property mask being the mask used to map a position to a slot
+		std::unique_ptr<cell[]> cells; ///< @property cells being the storage of the ring
+
+		char enqueuePadding[async::cache_line_size]; ///< @property enqueuePadding keeps the producers' position on its own cache line
+		std::atomic<index_type> enqueuePos{0}; ///< @property enqueuePos being the position of the next value to push
+
+		char dequeuePadding[async::cache_line_size]; ///< @property dequeuePadding keeps the consumers' position on its own cache line
+		std::atomic<index_type> dequeuePos{0}; ///< @property dequeuePos being the position of the next value to pop
+
+		char endPadding[async::cache_line_size]; ///< @property endPadding keeps the consumers' position away from whatever follows
+
+	public:
+		/**
+		 * Construct a queue with the given capacity
+		 * @param capacity being the minimum amount of values stored at once (rounded up to a power of two)
+		 */
+		explicit mpmc_queue(std::size_t capacity);
+
+		mpmc_queue(const mpmc_queue&) = delete;
+		mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+		/**
+		 * Destructor, destroys the values left in the ring
+		 */
+		~mpmc_queue();
+
+		bool try_push(value_type& value) override;
+		bool try_pop(value_type* storage) override;
+		bool evict() override;
+		std::size_t size() const override;
+		std::size_t capacity() const override{ return this->mask + 1; }
+};
+
+/**
+ * A Chase-Lev work-stealing deque: its owner pushes and pops at the bottom, any other thread steals from the top
+ * @tparam T The type of values stored in the deque (trivially copyable, usually a pointer)
+ */
+template <class T>
+class async::work_stealing_deque{
+	public:
+		using value_type = T; ///< @typedef value_type being the type of values stored in the deque
+		using index_type = std::int64_t; ///< @typedef index_type being the type of the (ever increasing) positions in the deque
+
+	protected:
+		/**
+		 * A circular array of values, replaced by a bigger one when the deque is full
+		 */
+		struct ring{
+			const index_type mask; ///< @property mask being the mask used to map a position to a slot
+			std::unique_ptr<std::atomic<value_type>[]> slots; ///< @property slots being the storage of the ring
+
+			explicit ring(index_type capacity) : mask{capacity - 1}, slots{new std::atomic<value_type>[static_cast<std::size_t>(capacity)]}{}
+
+			index_type capacity() const{ return this->mask + 1; }
+			value_type get(index_type position) const{ return this->slots[position & this->mask].load(std::memory_order_relaxed); }
+			void put(index_type position, value_type value){ this->slots[position & this->mask].store(value, std::memory_order_relaxed); }
+		};
+
+		char topPadding[async::cache_line_size]; ///< @property topPadding keeps the thieves' position on its own cache line
+		std::atomic<index_type> top{0}; ///< @property top being the position of the next value to steal
+
+		char bottomPadding[async::cache_line_size]; ///< @property bottomPadding keeps the owner's position on its own cache line
+		std::atomic<index_type> bottom{0}; ///< @property bottom being the position of the next value to push
+		std::atomic<ring*> array; ///< @property array being the ring currently in use
+		std::vector<std::unique_ptr<ring>> rings{}; ///< @property rings being every ring allocated so far (thieves may still read the old ones)
+
+		char endPadding[async::cache_line_size]; ///< @property endPadding keeps the owner's data away from whatever follows
+
+		/**
+		 * Replace the ring by one twice as big
+		 * @param current being the ring in use
+		 * @param bottom being the bottom position
+		 * @param top being the top position
+		 * @return the new ring
+		 */
+		ring* grow(ring* current, index_type bottom, index_type top);
+
+	public:
+		/**
+		 * Construct a deque with the given initial capacity
+		 * @param capacity being the initial amount of values stored at once (rounded up to a power of two, the deque grows as needed)
+		 */
+		explicit work_stealing_deque(std::size_t capacity = 256);
+
+		work_stealing_deque(const work_stealing_deque&) = delete;
+		work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+		/**
+		 * Push a value at the bottom of the deque
+		 * @param value being the value to push
+		 * @pre The calling thread owns the deque
+		 */
+		void push(value_type value);
+
+		/**
+		 * Pop the value at the bottom of the deque (the most recently pushed)
+		 * @param value being where to store the popped value
+		 * @return TRUE if a value has been popped, FALSE if the deque is empty
+		 * @pre The calling thread owns the deque
+		 */
+		bool pop(value_type& value);
+
+		/**
+		 * Steal the value at the top of the deque (the least recently pushed)
+		 * @param value being where to store the stolen value
+		 * @return TRUE if a value has been stolen, FALSE if the deque is empty or another thread took it first
+		 */
+		bool steal(value_type& value);
+
+		/**
+		 * Determine whether or not the deque is empty
+		 * @return TRUE if there is nothing to pop or steal (an approximation when accessed concurrently)
+		 */
+		bool empty() const{ return this->bottom.load(std::memory_order_acquire) <= this->top.load(std::memory_order_acquire); }
+};
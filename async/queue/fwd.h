@@ -0,0 +1,18 @@
+#pragma once
+
+namespace async{
+	template <class T>
+	class delivery_queue;
+
+	template <class T>
+	class locked_queue;
+
+	template <class T>
+	class spsc_queue;
+
+	template <class T>
+	class mpmc_queue;
+
+	template <class T>
+	class work_stealing_deque;
+}
@@ -0,0 +1,306 @@
+#pragma once
+#include <async/queue/decl.h>
+#include <async/memory/memory.hpp>
+#include <utility>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ASYNC_HAS_MM_PAUSE
+#endif
+
+inline void async::details::cpu_relax(){
+	#ifdef ASYNC_HAS_MM_PAUSE
+	_mm_pause();
+	#endif
+}
+
+inline std::size_t async::details::next_power_of_two(std::size_t value){
+	std::size_t power = 2;
+	while(power < value)
+		power <<= 1;
+
+	return power;
+}
+
+#undef ASYNC_HAS_MM_PAUSE
+
+#define TPL template <class T>
+#define self async::locked_queue<T>
+#define self_t typename self
+#define LOCK self_t::lock_guard _{this->mutex};
+
+TPL
+bool self::try_push(self_t::value_type& value){
+	LOCK
+	if(this->max != 0 && this->values.size() >= this->max)
+		return false;
+
+	this->values.push_back(std::move(value));
+	return true;
+}
+
+TPL
+bool self::try_pop(self_t::value_type* storage){
+	LOCK
+	if(this->values.empty())
+		return false;
+
+	new(storage) value_type(std::move(this->values.front()));
+	this->values.pop_front();
+	return true;
+}
+
+TPL
+bool self::evict(){
+	LOCK
+	if(this->values.empty())
+		return false;
+
+	this->values.pop_front();
+	return true;
+}
+
+TPL
+std::size_t self::size() const{
+	LOCK
+	return this->values.size();
+}
+
+#undef TPL
+#undef self
+#undef self_t
+#undef LOCK
+
+
+#define TPL template <class T>
+#define constructor spsc_queue
+#define self async::spsc_queue<T>
+#define self_t typename self
+
+TPL
+self::constructor(std::size_t capacity)
+: mask{async::details::next_power_of_two(capacity) - 1}, slots{new self_t::storage_type[async::details::next_power_of_two(capacity)]}{
+}
+
+TPL
+self::~constructor(){
+	for(auto position = this->head.load() ; position != this->tail.load() ; ++position)
+		this->at(position)->~value_type();
+}
+
+TPL
+bool self::try_push(self_t::value_type& value){
+	const auto position = this->tail.load(std::memory_order_relaxed);
+
+	if(position - this->cachedHead > this->mask){
+		this->cachedHead = this->head.load(std::memory_order_acquire);
+		if(position - this->cachedHead > this->mask)
+			return false;
+	}
+
+	new(this->at(position)) value_type(std::move(value));
+	this->tail.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+TPL
+bool self::try_pop(self_t::value_type* storage){
+	const auto position = this->head.load(std::memory_order_relaxed);
+
+	if(position == this->cachedTail){
+		this->cachedTail = this->tail.load(std::memory_order_acquire);
+		if(position == this->cachedTail)
+			return false;
+	}
+
+	auto* value = this->at(position);
+	new(storage) value_type(std::move(*value));
+	value->~value_type();
+	this->head.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+TPL
+std::size_t self::size() const{
+	const auto position = this->head.load(std::memory_order_acquire);
+	return this->tail.load(std::memory_order_acquire) - position;
+}
+
+#undef TPL
+#undef constructor
+#undef self
+#undef self_t
+
+
+#define TPL template <class T>
+#define constructor mpmc_queue
+#define self async::mpmc_queue<T>
+#define self_t typename self
+
+TPL
+self::constructor(std::size_t capacity)
+: mask{async::details::next_power_of_two(capacity) - 1}, cells{new self_t::cell[async::details::next_power_of_two(capacity)]}{
+	for(index_type i = 0 ; i <= this->mask ; ++i)
+		this->cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+TPL
+self::~constructor(){
+	for(auto position = this->dequeuePos.load() ; position != this->enqueuePos.load() ; ++position)
+		this->cells[position & this->mask].value()->~value_type();
+}
+
+TPL
+bool self::try_push(self_t::value_type& value){
+	auto position = this->enqueuePos.load(std::memory_order_relaxed);
+	self_t::cell* slot;
+
+	for(;;){
+		slot = &this->cells[position & this->mask];
+		const auto sequence = slot->sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+		if(diff == 0){
+			if(this->enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}else if(diff < 0)
+			return false;
+		else
+			position = this->enqueuePos.load(std::memory_order_relaxed);
+	}
+
+	new(slot->value()) value_type(std::move(value));
+	slot->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+TPL
+bool self::try_pop(self_t::value_type* storage){
+	auto position = this->dequeuePos.load(std::memory_order_relaxed);
+	self_t::cell* slot;
+
+	for(;;){
+		slot = &this->cells[position & this->mask];
+		const auto sequence = slot->sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+		if(diff == 0){
+			if(this->dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}else if(diff < 0)
+			return false;
+		else
+			position = this->dequeuePos.load(std::memory_order_relaxed);
+	}
+
+	auto* value = slot->value();
+	new(storage) value_type(std::move(*value));
+	value->~value_type();
+	slot->sequence.store(position + this->mask + 1, std::memory_order_release);
+	return true;
+}
+
+TPL
+bool self::evict(){
+	self_t::storage_type storage;
+	auto* value = reinterpret_cast<value_type*>(&storage);
+
+	if(!this->try_pop(value))
+		return false;
+
+	value->~value_type();
+	return true;
+}
+
+TPL
+std::size_t self::size() const{
+	const auto position = this->dequeuePos.load(std::memory_order_acquire);
+	const auto end = this->enqueuePos.load(std::memory_order_acquire);
+	return end > position ? end - position : 0;
+}
+
+#undef TPL
+#undef constructor
+#undef self
+#undef self_t
+
+
+#define TPL template <class T>
+#define constructor work_stealing_deque
+#define self async::work_stealing_deque<T>
+#define self_t typename self
+
+TPL
+self::constructor(std::size_t capacity){
+	this->rings.emplace_back(new ring(static_cast<index_type>(async::details::next_power_of_two(capacity))));
+	this->array.store(this->rings.back().get(), std::memory_order_relaxed);
+}
+
+TPL
+self_t::ring* self::grow(self_t::ring* current, self_t::index_type bottom, self_t::index_type top){
+	std::unique_ptr<ring> bigger{new ring(current->capacity() * 2)};
+	for(auto position = top ; position < bottom ; ++position)
+		bigger->put(position, current->get(position));
+
+	this->rings.push_back(std::move(bigger));
+	auto* result = this->rings.back().get();
+	this->array.store(result, std::memory_order_release);
+	return result;
+}
+
+TPL
+void self::push(self_t::value_type value){
+	const auto position = this->bottom.load(std::memory_order_relaxed);
+	const auto first = this->top.load(std::memory_order_acquire);
+	auto* current = this->array.load(std::memory_order_relaxed);
+
+	if(position - first > current->capacity() - 1)
+		current = this->grow(current, position, first);
+
+	current->put(position, value);
+	std::atomic_thread_fence(std::memory_order_release);
+	this->bottom.store(position + 1, std::memory_order_relaxed);
+}
+
+TPL
+bool self::pop(self_t::value_type& value){
+	const auto position = this->bottom.load(std::memory_order_relaxed) - 1;
+	auto* current = this->array.load(std::memory_order_relaxed);
+	this->bottom.store(position, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto first = this->top.load(std::memory_order_relaxed);
+
+	if(first > position){
+		this->bottom.store(position + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	value = current->get(position);
+	if(first != position)
+		return true;
+
+	//Last value: race the thieves for it
+	const bool won = this->top.compare_exchange_strong(first, first + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	this->bottom.store(position + 1, std::memory_order_relaxed);
+	return won;
+}
+
+TPL
+bool self::steal(self_t::value_type& value){
+	auto first = this->top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const auto position = this->bottom.load(std::memory_order_acquire);
+
+	if(first >= position)
+		return false;
+
+	auto* current = this->array.load(std::memory_order_acquire);
+	value = current->get(first);
+	return this->top.compare_exchange_strong(first, first + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+#undef TPL
+#undef constructor
+#undef self
+#undef self_t
@@ -0,0 +1,4 @@
+#pragma once
+#include <async/queue/fwd.h>
+#include <async/queue/decl.h>
+#include <async/queue/impl.h>
@@ -0,0 +1,126 @@
+#pragma once
+#include <async/rcu/fwd.h>
+#include <async/queue/decl.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/**
+ * An immutable value published RCU-style: readers never lock, writers publish an updated copy
+ * and retire the previous one until no reader can still be looking at it
+ * @tparam T The type of the published value
+ *
+ * Readers are counted per epoch (two counters, by parity): a writer starts a new epoch once the readers of the one
+ * before last are gone, the values retired before that are freed once the readers of the previous epoch are gone.
+ * A steady flow of readers thus joins the new epoch and does not hold back reclamation, only the readers that may
+ * still hold a retired value do.
+ *
+ * @warning Writers never wait for readers, a reader may thus update the cell it is reading
+ */
+template <class T>
+class async::rcu_cell{
+	public:
+		using value_type = T;///< @typedef value_type being the type of the published value
+		using mutex_type = std::mutex;///< @typedef mutex_type being the type of mutex used to serialize writers
+		using lock_guard = std::lock_guard<mutex_type>;///< @typedef lock_guard being the type of lock guard used to serialize writers
+
+		/**
+		 * Keeps the value published at the time it was acquired alive for as long as it exists
+		 */
+		class read_guard{
+			protected:
+				const rcu_cell* cell;///< @property cell being the cell being read
+				const value_type* value;///< @property value being the value being read
+				std::size_t parity;///< @property parity being the counter this reader has been counted in
+
+			public:
+				explicit read_guard(const rcu_cell& cell);
+				read_guard(read_guard&& other) noexcept : cell{other.cell}, value{other.value}, parity{other.parity}{ other.cell = nullptr; }
+				read_guard(const read_guard&) = delete;
+				read_guard& operator=(const read_guard&) = delete;
+				~read_guard();
+
+				const value_type& operator*() const{ return *this->value; }
+				const value_type* operator->() const{ return this->value; }
+		};
+
+	protected:
+		/**
+		 * The amount of readers of the epochs of a parity, on its own cache line
+		 */
+		struct reader_counter{
+			std::atomic<std::size_t> count{0};///< @property count being the amount of readers currently holding a value
+			char padding[async::cache_line_size - sizeof(std::atomic<std::size_t>)];///< @property padding keeps the counters apart
+		};
+
+		std::atomic<const value_type*> current;///< @property current being the published value
+		mutable std::atomic<std::size_t> epoch{0};///< @property epoch being the epoch new readers are counted in (by its parity)
+
+		char readersPadding[async::cache_line_size];///< @property readersPadding keeps the readers' counters away from the published pointer
+		mutable reader_counter readers[2];///< @property readers being the readers of the even and odd epochs
+
+		mutable mutex_type mutex{};///< @property mutex being the mutex used to serialize writers and reclamation
+		mutable std::vector<const value_type*> retired{};///< @property retired being the values replaced during the current epoch
+		mutable std::vector<const value_type*> waiting{};///< @property waiting being the values replaced during the previous epoch, read by its readers at most
+		mutable std::atomic<bool> hasRetired{false};///< @property hasRetired being whether or not some values await reclamation
+
+		/**
+		 * Free the values no reader can still hold, starting a new epoch when the readers of the one before last are gone
+		 * @pre The writers' mutex is held
+		 */
+		void reclaim() const;
+
+		/**
+		 * Called by readers when they are done
+		 * @param parity being the counter the reader has been counted in
+		 */
+		void leave(std::size_t parity) const;
+
+		/**
+		 * Replace the published value, retiring the previous one
+		 * @param value being the value to publish
+		 * @pre The writers' mutex is held
+		 */
+		void publish(const value_type* value);
+
+	public:
+		/**
+		 * Construct a cell publishing a default constructed value
+		 */
+		rcu_cell();
+
+		/**
+		 * Construct a cell publishing the given value
+		 * @param value being the value to publish
+		 */
+		explicit rcu_cell(value_type value);
+
+		rcu_cell(const rcu_cell&) = delete;
+		rcu_cell& operator=(const rcu_cell&) = delete;
+
+		/**
+		 * Destructor, frees the published and retired values
+		 * @pre No reader is active
+		 */
+		~rcu_cell();
+
+		/**
+		 * Acquire the published value (lock-free)
+		 * @return a guard keeping the value alive
+		 */
+		read_guard read() const{ return read_guard{*this}; }
+
+		/**
+		 * Publish an updated copy of the value
+		 * @tparam Updater - Updater :: (value_type&) -> void
+		 * @param updater being the function applied to the copy before it is published
+		 */
+		template <class Updater>
+		void update(Updater updater);
+
+		/**
+		 * Publish a new value
+		 * @param value being the value to publish
+		 */
+		void store(value_type value);
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace async{
+	template <class T>
+	class rcu_cell;
+}
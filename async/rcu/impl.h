@@ -0,0 +1,107 @@
+#pragma once
+#include <async/rcu/decl.h>
+#include <memory>
+#include <utility>
+
+#define TPL template <class T>
+#define constructor rcu_cell
+#define self async::rcu_cell<T>
+#define self_t typename self
+#define LOCK self_t::lock_guard _{this->mutex};
+
+TPL
+self::read_guard::read_guard(const self_t::rcu_cell& cell) : cell{&cell}, parity{cell.epoch.load() & 1}{
+	//Any value retired after this increment is seen as being read, hence not freed (even if the epoch has changed since it was loaded)
+	cell.readers[this->parity].count.fetch_add(1);
+	this->value = cell.current.load();
+}
+
+TPL
+self::read_guard::~read_guard(){
+	if(this->cell)
+		this->cell->leave(this->parity);
+}
+
+TPL
+void self::leave(std::size_t parity) const{
+	if(this->readers[parity].count.fetch_sub(1) != 1 || !this->hasRetired.load())
+		return;
+
+	//The last reader of an epoch frees what it was holding back, unless a writer is busy (it will reclaim)
+	std::unique_lock<mutex_type> lock{this->mutex, std::try_to_lock};
+	if(lock.owns_lock())
+		this->reclaim();
+}
+
+TPL
+void self::reclaim() const{
+	//Retired values have been swapped out before being retired: a reader counted after a check below cannot reach them,
+	//a reader counted before it holds the counter of its parity above 0 until it leaves
+	while(!this->waiting.empty() || !this->retired.empty()){
+		const auto epoch = this->epoch.load();
+		if(this->readers[(epoch + 1) & 1].count.load() != 0)
+			break;
+
+		//The readers of the previous epoch are gone, so is whatever they could hold
+		for(const auto* value : this->waiting)
+			delete value;
+
+		this->waiting.clear();
+
+		//New readers now join the next epoch, the values retired during this one only wait for the readers already in it
+		this->waiting.swap(this->retired);
+		if(!this->waiting.empty())
+			this->epoch.store(epoch + 1);
+	}
+
+	this->hasRetired.store(!this->waiting.empty() || !this->retired.empty());
+}
+
+TPL
+self::constructor() : current{new value_type{}}{
+}
+
+TPL
+self::constructor(self_t::value_type value) : current{new value_type(std::move(value))}{
+}
+
+TPL
+self::~constructor(){
+	for(const auto* value : this->retired)
+		delete value;
+
+	for(const auto* value : this->waiting)
+		delete value;
+
+	delete this->current.load();
+}
+
+TPL
+template <class Updater>
+void self::update(Updater updater){
+	LOCK
+	std::unique_ptr<value_type> copy{new value_type(*this->current.load())};
+
+	//If the updater throws, the copy is discarded and nothing is published
+	updater(*copy);
+	this->publish(copy.release());
+}
+
+TPL
+void self::store(self_t::value_type value){
+	LOCK
+	this->publish(new value_type(std::move(value)));
+}
+
+TPL
+void self::publish(const self_t::value_type* value){
+	const auto* old = this->current.exchange(value);
+	this->retired.push_back(old);
+	this->hasRetired.store(true);
+	this->reclaim();
+}
+#undef TPL
+#undef constructor
+#undef self
+#undef self_t
+#undef LOCK
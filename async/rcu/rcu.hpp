@@ -0,0 +1,4 @@
+#pragma once
+#include <async/rcu/fwd.h>
+#include <async/rcu/decl.h>
+#include <async/rcu/impl.h>
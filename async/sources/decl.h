@@ -0,0 +1,256 @@
+#pragma once
+#include <async/sources/fwd.h>
+#include <async/task/decl.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <iosfwd>
+#include <vector>
+
+/**
+ * A line of text that shares ownership of the memory it lives in (a mapped file or a read buffer):
+ * copying it never copies the text, the memory is released once every line sliced from it is gone
+ */
+class async::line_view{
+	public:
+		using value_type = char; ///< @typedef value_type being the type of characters viewed
+		using const_iterator = const char*; ///< @typedef const_iterator being the type of iterators over the characters
+		using size_type = std::size_t; ///< @typedef size_type being the type used to count characters
+		using owner_type = std::shared_ptr<const char>; ///< @typedef owner_type being the type of pointer that keeps the text alive (aliasing the real owner)
+
+	protected:
+		owner_type first{}; ///< @property first being a pointer to the first character
+		size_type count = 0; ///< @property count being the amount of characters
+
+	public:
+		/**
+		 * Construct an empty line
+		 */
+		line_view() = default;
+
+		/**
+		 * Construct a line over the given characters
+		 * @param data being a pointer to the first character (that shares the ownership of the text)
+		 * @param size being the amount of characters
+		 */
+		line_view(owner_type data, size_type size) : first{std::move(data)}, count{size}{}
+
+		const char* data() const{ return this->first.get(); }
+		size_type size() const{ return this->count; }
+		size_type length() const{ return this->count; }
+		bool empty() const{ return this->count == 0; }
+		const_iterator begin() const{ return this->data(); }
+		const_iterator end() const{ return this->data() + this->count; }
+		char operator[](size_type i) const{ return this->data()[i]; }
+
+		/**
+		 * Copy the characters of this line
+		 * @return a string holding the line
+		 */
+		std::string str() const{ return std::string{this->data(), this->count}; }
+
+		/**
+		 * Compare the characters of two lines
+		 * @param other being the line to compare to
+		 * @return a negative value if this line comes first, 0 if they are equal, a positive value otherwise
+		 */
+		int compare(const line_view& other) const;
+		int compare(const char* other, size_type size) const;
+
+		bool operator==(const line_view& other) const{ return this->compare(other) == 0; }
+		bool operator!=(const line_view& other) const{ return this->compare(other) != 0; }
+		bool operator<(const line_view& other) const{ return this->compare(other) < 0; }
+		bool operator==(const std::string& other) const{ return this->compare(other.data(), other.size()) == 0; }
+		bool operator!=(const std::string& other) const{ return !(*this == other); }
+};
+
+namespace async{
+	/**
+	 * Write the characters of a line
+	 * @param os being the stream to write to
+	 * @param line being the line to write
+	 * @return os
+	 */
+	inline std::ostream& operator<<(std::ostream& os, const line_view& line);
+}
+
+/**
+ * A read-only memory mapping of a whole file
+ */
+class async::details::mapped_file{
+	protected:
+		const char* first = nullptr; ///< @property first being the first byte of the mapping
+		std::size_t count = 0; ///< @property count being the size of the mapping
+
+	public:
+		/**
+		 * Map a file
+		 * @param path being the path to the file
+		 * @post Check async::details::mapped_file::valid, a file that is not a regular file (eg. a pipe) cannot be mapped
+		 */
+		explicit mapped_file(const char* path);
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		/**
+		 * Destructor, unmaps the file
+		 */
+		~mapped_file();
+
+		/**
+		 * Determine whether or not the file has been mapped (an empty file never is)
+		 * @return TRUE if the file is mapped, FALSE otherwise
+		 */
+		bool valid() const{ return this->first != nullptr; }
+
+		const char* data() const{ return this->first; }
+		std::size_t size() const{ return this->count; }
+};
+
+/**
+ * The settings of the file sources
+ */
+struct async::sources::line_options{
+	static constexpr std::size_t DEFAULT_BATCH = 1024; ///< @property DEFAULT_BATCH being the default amount of lines emitted at once
+	static constexpr std::size_t DEFAULT_BUFFER = 1 << 16; ///< @property DEFAULT_BUFFER being the default size of the read buffers (when the file is not mapped)
+
+	std::size_t batch = DEFAULT_BATCH; ///< @property batch being the maximum amount of lines emitted at once (as a single batch)
+	std::size_t buffer = DEFAULT_BUFFER; ///< @property buffer being the size of the read buffers (grown to fit longer lines)
+	bool mapping = true; ///< @property mapping being whether or not to try mapping the file before streaming it
+	std::size_t chunks = 1; ///< @property chunks being the amount of parallel producers a mapped file is split between (0 means one per worker of the task's executor)
+
+	/**
+	 * Emit up to the given amount of lines at once
+	 * @param value being the maximum amount of lines per batch
+	 * @return a reference to these options
+	 */
+	line_options& withBatch(std::size_t value){
+		this->batch = value == 0 ? 1 : value;
+		return *this;
+	}
+
+	/**
+	 * Read the file by chunks of the given size when it is not mapped
+	 * @param value being the size of the read buffers
+	 * @return a reference to these options
+	 */
+	line_options& withBuffer(std::size_t value){
+		this->buffer = value == 0 ? 1 : value;
+		return *this;
+	}
+
+	/**
+	 * Select whether or not to try mapping the file (pipes and special files are always streamed)
+	 * @param value being TRUE to map regular files, FALSE to always stream
+	 * @return a reference to these options
+	 */
+	line_options& withMapping(bool value){
+		this->mapping = value;
+		return *this;
+	}
+
+	/**
+	 * Split a mapped file into newline-aligned chunks emitted by parallel producers (lines of different chunks are then emitted in no particular order)
+	 * @param value being the amount of chunks (0 means one per worker of the task's executor, 1 disables splitting)
+	 * @return a reference to these options
+	 * @warning The stream must accept several producers at once (not async::queue_mode::spsc)
+	 */
+	line_options& withChunks(std::size_t value){
+		this->chunks = value;
+		return *this;
+	}
+};
+
+/**
+ * The handler of a task emitting the lines of a file (without their line terminator, "\n" or "\r\n")
+ */
+class async::sources::lines_source{
+	public:
+		using value_type = async::line_view; ///< @typedef value_type being the type of values emitted
+		using task_type = async::task<value_type>; ///< @typedef task_type being the type of task run by this source
+		using stream_type = async::stream<value_type>; ///< @typedef stream_type being the type of stream fed by this source
+		using options_type = line_options; ///< @typedef options_type being the type of settings of this source
+
+		static constexpr std::size_t SCAN_BLOCK = 256; ///< @property SCAN_BLOCK being the maximum amount of line feeds found per scan
+		static constexpr std::size_t MIN_CHUNK = 1 << 20; ///< @property MIN_CHUNK being the minimum size of the chunks a mapped file is split into
+
+	protected:
+		std::string path; ///< @property path being the path to the file to read
+		options_type opts; ///< @property opts being the settings of this source
+
+		/**
+		 * Emit the complete lines of a range of text (the text after its last line feed is left to the caller)
+		 * @tparam Owner - The type of object that owns the text
+		 * @param owner being the owner of the text, shared by the lines
+		 * @param first being the beginning of the text
+		 * @param last being the end of the text
+		 * @param lines being the lines not emitted yet (emitted by batches)
+		 * @param task being the task running this source
+		 * @param stream being the stream to feed
+		 * @return the beginning of the text after the last line feed, nullptr if a stop has been requested
+		 */
+		template <class Owner>
+		const char* emitLines(const std::shared_ptr<Owner>& owner, const char* first, const char* last, std::vector<value_type>& lines, task_type& task, stream_type& stream) const;
+
+		/**
+		 * Emit the lines not emitted yet as a batch
+		 * @param lines being the lines to emit (emptied)
+		 * @param stream being the stream to feed
+		 */
+		void flush(std::vector<value_type>& lines, stream_type& stream) const;
+
+		/**
+		 * Emit the lines of a newline-aligned chunk of a mapped file
+		 * @param file being the mapping
+		 * @param first being the beginning of the chunk
+		 * @param last being the end of the chunk
+		 * @param task being the task running this source
+		 * @param stream being the stream to feed
+		 */
+		void emitChunk(const std::shared_ptr<const async::details::mapped_file>& file, const char* first, const char* last, task_type& task, stream_type& stream) const;
+
+		/**
+		 * Emit the lines of a mapped file, split between parallel producers if requested
+		 * @param file being the mapping
+		 * @param task being the task running this source
+		 * @param stream being the stream to feed
+		 */
+		void emitMapped(const std::shared_ptr<const async::details::mapped_file>& file, task_type& task, stream_type& stream) const;
+
+		/**
+		 * Emit the lines of a file read by chunks
+		 * @param file being the (opened) file to read
+		 * @param task being the task running this source
+		 * @param stream being the stream to feed
+		 */
+		void emitStreamed(std::istream& file, task_type& task, stream_type& stream) const;
+
+	public:
+		/**
+		 * Construct a source for the given file
+		 * @param path being the path to the file
+		 * @param options being the settings of the source
+		 */
+		lines_source(std::string path, options_type options) : path{std::move(path)}, opts{options}{}
+
+		/**
+		 * Emit every line of the file, stops early when a stop is requested
+		 * @param task being the task running this source
+		 * @param stream being the stream to feed
+		 */
+		void operator()(task_type& task, stream_type& stream) const;
+};
+
+namespace async{
+	namespace sources{
+		/**
+		 * Create the handler of a task that emits the lines of a file: regular files are memory-mapped, anything
+		 * else (eg. a pipe) is read by chunks, lines are emitted by batches as views on the file (no per-line allocation)
+		 * @param path being the path to the file
+		 * @param options being the settings of the source
+		 * @return the handler, to construct an async::task<async::line_view> with
+		 */
+		inline lines_source lines(std::string path, line_options options = line_options{});
+	}
+}
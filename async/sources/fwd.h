@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * @def ASYNC_HAS_MMAP
+ * Defined when files can be memory-mapped (POSIX systems)
+ */
+#if !defined(ASYNC_HAS_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define ASYNC_HAS_MMAP 1
+#endif
+
+namespace async{
+	class line_view;
+
+	namespace sources{
+		struct line_options;
+		class lines_source;
+	}
+
+	namespace details{
+		class mapped_file;
+	}
+}
@@ -0,0 +1,240 @@
+#pragma once
+#include <async/sources/decl.h>
+#include <async/task/task.hpp>
+#include <async/sources/scan.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <vector>
+
+#ifdef ASYNC_HAS_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace async{
+	namespace details{
+		/**
+		 * Compute the length of a line once its carriage return (if any) is stripped
+		 * @param first being the first character of the line
+		 * @param last being the end of the line (its line feed, if any)
+		 * @return the amount of characters of the line
+		 */
+		inline std::size_t line_length(const char* first, const char* last){
+			return static_cast<std::size_t>((last != first && last[-1] == '\r') ? last - first - 1 : last - first);
+		}
+	}
+}
+
+
+#define self async::line_view
+
+inline int self::compare(const char* other, self::size_type size) const{
+	const auto common = std::min(this->count, size);
+	const int result = common == 0 ? 0 : std::memcmp(this->data(), other, common);
+
+	if(result != 0)
+		return result;
+
+	return this->count < size ? -1 : (this->count > size ? 1 : 0);
+}
+
+inline int self::compare(const self& other) const{
+	return this->compare(other.data(), other.size());
+}
+
+inline std::ostream& async::operator<<(std::ostream& os, const self& line){
+	return os.write(line.data(), static_cast<std::streamsize>(line.size()));
+}
+
+#undef self
+
+
+#define self async::details::mapped_file
+#define constructor mapped_file
+
+inline self::constructor(const char* path){
+	#ifdef ASYNC_HAS_MMAP
+	const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		return;
+
+	struct stat info;
+	if(::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0){
+		const auto size = static_cast<std::size_t>(info.st_size);
+		void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if(mapping != MAP_FAILED){
+			::madvise(mapping, size, MADV_SEQUENTIAL);
+			this->first = static_cast<const char*>(mapping);
+			this->count = size;
+		}
+	}
+
+	::close(fd);
+	#else
+	(void)path;
+	#endif
+}
+
+inline self::~constructor(){
+	#ifdef ASYNC_HAS_MMAP
+	if(this->first)
+		::munmap(const_cast<char*>(this->first), this->count);
+	#endif
+}
+
+#undef self
+#undef constructor
+
+
+#define self async::sources::lines_source
+
+template <class Owner>
+const char* self::emitLines(const std::shared_ptr<Owner>& owner, const char* first, const char* last, std::vector<self::value_type>& lines, self::task_type& task, self::stream_type& stream) const{
+	const char* found[self::SCAN_BLOCK];
+	const char* cursor = first;
+
+	for(const char* scanned = first ; scanned != last ;){
+		const auto count = async::details::scan_newlines(scanned, last, found, self::SCAN_BLOCK, &scanned);
+
+		for(std::size_t i = 0 ; i < count ; ++i){
+			//Each line shares the ownership of the text, copying it is never needed
+			lines.emplace_back(value_type::owner_type{owner, cursor}, async::details::line_length(cursor, found[i]));
+			cursor = found[i] + 1;
+
+			if(lines.size() == this->opts.batch){
+				this->flush(lines, stream);
+
+				if(task.stopRequested())
+					return nullptr;
+			}
+		}
+	}
+
+	return cursor;
+}
+
+inline void self::flush(std::vector<self::value_type>& lines, self::stream_type& stream) const{
+	if(lines.empty())
+		return;
+
+	stream.emitBatch(std::move(lines));
+	lines.clear();
+	lines.reserve(this->opts.batch);
+}
+
+inline void self::emitChunk(const std::shared_ptr<const async::details::mapped_file>& file, const char* first, const char* last, self::task_type& task, self::stream_type& stream) const{
+	std::vector<value_type> lines;
+	lines.reserve(this->opts.batch);
+
+	const char* const rest = this->emitLines(file, first, last, lines, task, stream);
+	if(!rest)
+		return;
+
+	if(rest != last)
+		lines.emplace_back(value_type::owner_type{file, rest}, async::details::line_length(rest, last));
+
+	this->flush(lines, stream);
+}
+
+inline void self::emitMapped(const std::shared_ptr<const async::details::mapped_file>& file, self::task_type& task, self::stream_type& stream) const{
+	const char* const first = file->data();
+	const char* const last = first + file->size();
+	const auto executor = task.executor();
+	const std::size_t chunks = std::max<std::size_t>(1, this->opts.chunks == 0 ? executor->concurrency() : this->opts.chunks);
+
+	if(chunks == 1 || file->size() < chunks * self::MIN_CHUNK)
+		return this->emitChunk(file, first, last, task, stream);
+
+	//Each chunk ends right after a line feed, so that no line is split between two producers
+	std::vector<const char*> bounds{first};
+	for(std::size_t i = 1 ; i < chunks ; ++i){
+		const char* bound = first + file->size() / chunks * i;
+		bound = async::details::find_newline(std::max(bound, bounds.back()), last);
+		bounds.push_back(bound == last ? last : bound + 1);
+	}
+	bounds.push_back(last);
+
+	async::task_group producers{executor};
+	for(std::size_t i = 0 ; i + 1 < bounds.size() ; ++i){
+		const char* const begin = bounds[i];
+		const char* const end = bounds[i + 1];
+
+		if(begin != end)
+			producers.run([this, &file, begin, end, &task, &stream]{
+				this->emitChunk(file, begin, end, task, stream);
+			});
+	}
+
+	producers.wait();
+}
+
+inline void self::emitStreamed(std::istream& file, self::task_type& task, self::stream_type& stream) const{
+	using buffer_type = std::vector<char>;
+
+	std::vector<value_type> lines;
+	lines.reserve(this->opts.batch);
+
+	auto buffer = std::make_shared<buffer_type>(this->opts.buffer);
+	std::size_t carried = 0;
+
+	for(;;){
+		file.read(buffer->data() + carried, static_cast<std::streamsize>(buffer->size() - carried));
+		const char* const last = buffer->data() + carried + static_cast<std::size_t>(file.gcount());
+		const bool over = !file;
+
+		//Lines are views on the buffer, which is released once every one of them is gone
+		const std::shared_ptr<const buffer_type> owner = buffer;
+		const char* const rest = this->emitLines(owner, buffer->data(), last, lines, task, stream);
+		if(!rest)
+			return;
+
+		const auto partial = static_cast<std::size_t>(last - rest);
+
+		if(over){
+			if(partial != 0)
+				lines.emplace_back(value_type::owner_type{owner, rest}, async::details::line_length(rest, last));
+
+			break;
+		}
+
+		//The beginning of the next line moves to a new buffer (twice as big if it fills the whole buffer)
+		auto next = std::make_shared<buffer_type>(partial * 2 > buffer->size() ? buffer->size() * 2 : buffer->size());
+		std::copy(rest, last, next->data());
+		buffer = std::move(next);
+		carried = partial;
+	}
+
+	this->flush(lines, stream);
+}
+
+inline void self::operator()(self::task_type& task, self::stream_type& stream) const{
+	#ifdef ASYNC_HAS_MMAP
+	if(this->opts.mapping){
+		std::shared_ptr<const async::details::mapped_file> file{new async::details::mapped_file{this->path.c_str()}};
+		if(file->valid())
+			return this->emitMapped(file, task, stream);
+	}
+	#endif
+
+	std::ifstream file{this->path, std::ios::in | std::ios::binary};
+	if(!file.is_open()){
+		task.stop("Could not open file");
+		return;
+	}
+
+	this->emitStreamed(file, task, stream);
+
+	if(file.bad())
+		task.stop("Stopped reading file before EOF");
+}
+
+inline async::sources::lines_source async::sources::lines(std::string path, async::sources::line_options options){
+	return lines_source{std::move(path), options};
+}
+
+#undef self
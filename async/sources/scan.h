@@ -0,0 +1,155 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @def ASYNC_SIMD_X86
+ * Defined when the newline scanners can use SSE2/AVX2 (x86 with GCC or Clang, define ASYNC_NO_SIMD to opt out)
+ */
+#if !defined(ASYNC_NO_SIMD) && !defined(ASYNC_SIMD_X86) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ASYNC_SIMD_X86 1
+#endif
+
+#ifdef ASYNC_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace async{
+	namespace details{
+		/**
+		 * The signature of the newline scanners: find the line feeds of a range of characters
+		 * @param first being the beginning of the range
+		 * @param last being the end of the range
+		 * @param found being where to store pointers to the line feeds found
+		 * @param capacity being the maximum amount of line feeds to find
+		 * @param resume being where to store the position to resume the scan from
+		 * @return the amount of line feeds found
+		 */
+		using newline_scanner = std::size_t(*)(const char* first, const char* last, const char** found, std::size_t capacity, const char** resume);
+
+		/**
+		 * Find the line feeds one byte at a time (the portable fallback, also used for the tail of the vectorized scans)
+		 */
+		inline std::size_t scan_newlines_scalar(const char* first, const char* last, const char** found, std::size_t capacity, const char** resume){
+			std::size_t count = 0;
+
+			for(; first != last ; ++first){
+				if(*first != '\n')
+					continue;
+
+				if(count == capacity){
+					*resume = first;
+					return count;
+				}
+
+				found[count++] = first;
+			}
+
+			*resume = last;
+			return count;
+		}
+
+		#ifdef ASYNC_SIMD_X86
+		/**
+		 * Record the line feeds of a block, given the mask of their positions
+		 * @return FALSE if there is no room left (resume is then set)
+		 */
+		inline bool record_newlines(const char* block, unsigned mask, const char** found, std::size_t capacity, std::size_t& count, const char** resume){
+			while(mask != 0){
+				const char* const position = block + __builtin_ctz(mask);
+
+				if(count == capacity){
+					*resume = position;
+					return false;
+				}
+
+				found[count++] = position;
+				mask &= mask - 1;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Find the line feeds 16 bytes at a time (SSE2, available on every x86-64 CPU)
+		 */
+		__attribute__((target("sse2")))
+		inline std::size_t scan_newlines_sse2(const char* first, const char* last, const char** found, std::size_t capacity, const char** resume){
+			const __m128i newline = _mm_set1_epi8('\n');
+			std::size_t count = 0;
+
+			for(; last - first >= 16 ; first += 16){
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+				const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+
+				if(!record_newlines(first, mask, found, capacity, count, resume))
+					return count;
+			}
+
+			return count + scan_newlines_scalar(first, last, found + count, capacity - count, resume);
+		}
+
+		/**
+		 * Find the line feeds 32 bytes at a time (AVX2)
+		 */
+		__attribute__((target("avx2")))
+		inline std::size_t scan_newlines_avx2(const char* first, const char* last, const char** found, std::size_t capacity, const char** resume){
+			const __m256i newline = _mm256_set1_epi8('\n');
+			std::size_t count = 0;
+
+			for(; last - first >= 32 ; first += 32){
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+				const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+
+				if(!record_newlines(first, mask, found, capacity, count, resume))
+					return count;
+			}
+
+			return count + scan_newlines_sse2(first, last, found + count, capacity - count, resume);
+		}
+		#endif
+
+		/**
+		 * Select the fastest newline scanner the CPU supports (checked once)
+		 * @return the scanner to use
+		 */
+		inline newline_scanner select_newline_scanner(){
+			#ifdef ASYNC_SIMD_X86
+			__builtin_cpu_init();
+
+			if(__builtin_cpu_supports("avx2"))
+				return scan_newlines_avx2;
+
+			if(__builtin_cpu_supports("sse2"))
+				return scan_newlines_sse2;
+			#endif
+
+			return scan_newlines_scalar;
+		}
+
+		/**
+		 * Find the line feeds of a range of characters with the fastest scanner available
+		 * @param first being the beginning of the range
+		 * @param last being the end of the range
+		 * @param found being where to store pointers to the line feeds found
+		 * @param capacity being the maximum amount of line feeds to find
+		 * @param resume being where to store the position to resume the scan from (last once the whole range has been scanned)
+		 * @return the amount of line feeds found
+		 */
+		inline std::size_t scan_newlines(const char* first, const char* last, const char** found, std::size_t capacity, const char** resume){
+			static const newline_scanner scanner = select_newline_scanner();
+			return scanner(first, last, found, capacity, resume);
+		}
+
+		/**
+		 * Find the first line feed of a range of characters
+		 * @param first being the beginning of the range
+		 * @param last being the end of the range
+		 * @return a pointer to the line feed, last if there is none
+		 */
+		inline const char* find_newline(const char* first, const char* last){
+			const void* found = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+			return found ? static_cast<const char*>(found) : last;
+		}
+	}
+}
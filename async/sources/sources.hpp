@@ -0,0 +1,4 @@
+#pragma once
+#include <async/sources/fwd.h>
+#include <async/sources/decl.h>
+#include <async/sources/impl.h>
@@ -0,0 +1,122 @@
+#pragma once
+#include <async/stop/fwd.h>
+#include <async/function/decl.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * The state shared by a stop source, its tokens and the callbacks registered on them
+ */
+struct async::details::stop_state{
+	std::atomic_bool requested{false};///< @property requested being whether or not a stop has been requested
+	std::mutex mutex{};///< @property mutex being the mutex used to lock the list of callbacks
+	async::stop_callback* callbacks = nullptr;///< @property callbacks being the first callback not run yet
+	async::stop_callback* running = nullptr;///< @property running being the callback currently run by the requesting thread
+	std::thread::id requester{};///< @property requester being the thread running the callbacks
+};
+
+/**
+ * A cheap, copyable view on a stop source used to determine whether a stop has been requested
+ */
+class async::stop_token{
+	friend class async::stop_source;
+	friend class async::stop_callback;
+
+	protected:
+		std::shared_ptr<async::details::stop_state> state;///< @property state being the state of the source (nullptr if there is none)
+
+		explicit stop_token(std::shared_ptr<async::details::stop_state> state) : state{std::move(state)}{}
+
+	public:
+		/**
+		 * Construct a token no stop can ever be requested on
+		 */
+		stop_token() = default;
+
+		/**
+		 * Determine whether or not a stop has been requested (a single atomic load)
+		 * @return TRUE if a stop has been requested, FALSE otherwise
+		 */
+		bool stop_requested() const{ return this->state && this->state->requested.load(std::memory_order_acquire); }
+
+		/**
+		 * Determine whether or not a stop may ever be requested
+		 * @return TRUE if this token is associated to a source, FALSE otherwise
+		 */
+		bool stop_possible() const{ return static_cast<bool>(this->state); }
+};
+
+/**
+ * The side of a cancellation that requests the stop, shared by a task, its stream and the streams derived from it
+ */
+class async::stop_source{
+	protected:
+		std::shared_ptr<async::details::stop_state> state;///< @property state being the state shared with the tokens
+
+	public:
+		/**
+		 * Construct a new source
+		 */
+		stop_source() : state{std::make_shared<async::details::stop_state>()}{}
+
+		/**
+		 * Ask for a stop, running the registered callbacks on the calling thread
+		 * @return TRUE if this call requested the stop, FALSE if it already was
+		 */
+		bool request_stop();
+
+		/**
+		 * Determine whether or not a stop has been requested
+		 * @return TRUE if a stop has been requested, FALSE otherwise
+		 */
+		bool stop_requested() const{ return this->state->requested.load(std::memory_order_acquire); }
+
+		/**
+		 * Get a token associated to this source
+		 * @return the token
+		 */
+		stop_token get_token() const{ return stop_token{this->state}; }
+
+		/**
+		 * Determine whether or not two sources share the same state
+		 * @param other being the source to compare to
+		 * @return TRUE if a stop requested on one is a stop requested on the other
+		 */
+		bool operator==(const stop_source& other) const{ return this->state == other.state; }
+		bool operator!=(const stop_source& other) const{ return !(*this == other); }
+};
+
+/**
+ * A callback run once a stop is requested (right away if it already was), deregistered when destroyed
+ */
+class async::stop_callback{
+	friend class async::stop_source;
+
+	public:
+		using callback_type = async::inplace_function<void()>;///< @typedef callback_type being the type of callback run
+
+	protected:
+		std::shared_ptr<async::details::stop_state> state;///< @property state being the state the callback is registered on
+		callback_type callback;///< @property callback being the function to run
+		stop_callback* previous = nullptr;///< @property previous being the previous callback in the list
+		stop_callback* next = nullptr;///< @property next being the next callback in the list
+		std::atomic_bool done{false};///< @property done being whether or not the callback has been run
+
+	public:
+		/**
+		 * Register a callback
+		 * @param token being the token associated to the source to watch
+		 * @param callback being the function to run once a stop is requested
+		 */
+		stop_callback(const stop_token& token, callback_type callback);
+
+		stop_callback(const stop_callback&) = delete;
+		stop_callback& operator=(const stop_callback&) = delete;
+
+		/**
+		 * Destructor, deregisters the callback (waits for it if it is being run by another thread)
+		 */
+		~stop_callback();
+};
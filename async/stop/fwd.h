@@ -0,0 +1,11 @@
+#pragma once
+
+namespace async{
+	class stop_source;
+	class stop_token;
+	class stop_callback;
+
+	namespace details{
+		struct stop_state;
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <async/stop/decl.h>
+#include <async/function/function.hpp>
+#include <utility>
+
+inline bool async::stop_source::request_stop(){
+	auto& state = *this->state;
+	if(state.requested.exchange(true, std::memory_order_acq_rel))
+		return false;
+
+	std::unique_lock<std::mutex> lock{state.mutex};
+	state.requester = std::this_thread::get_id();
+
+	while(state.callbacks){
+		auto* callback = state.callbacks;
+		state.callbacks = callback->next;
+		if(state.callbacks)
+			state.callbacks->previous = nullptr;
+
+		callback->next = callback->previous = nullptr;
+		state.running = callback;
+		lock.unlock();
+
+		callback->callback();
+
+		lock.lock();
+		//Once done, the callback may be destroyed by its owner: it must not be touched afterwards
+		state.running = nullptr;
+		callback->done.store(true, std::memory_order_release);
+	}
+
+	return true;
+}
+
+
+#define self async::stop_callback
+#define constructor stop_callback
+
+inline self::constructor(const async::stop_token& token, self::callback_type callback) : state{token.state}, callback{std::move(callback)}{
+	if(!this->state)
+		return;
+
+	{
+		std::lock_guard<std::mutex> _{this->state->mutex};
+		if(!this->state->requested.load(std::memory_order_acquire)){
+			this->next = this->state->callbacks;
+			if(this->next)
+				this->next->previous = this;
+
+			this->state->callbacks = this;
+			return;
+		}
+	}
+
+	this->callback();
+	this->done.store(true, std::memory_order_release);
+}
+
+inline self::~constructor(){
+	if(!this->state)
+		return;
+
+	std::unique_lock<std::mutex> lock{this->state->mutex};
+	if(this->previous || this->state->callbacks == this){
+		if(this->previous)
+			this->previous->next = this->next;
+		else
+			this->state->callbacks = this->next;
+
+		if(this->next)
+			this->next->previous = this->previous;
+
+		return;
+	}
+
+	//Run (or about to be run) by the requesting thread, unless it is this one (the callback destroys itself)
+	if(this->state->running != this || this->state->requester == std::this_thread::get_id())
+		return;
+
+	lock.unlock();
+	while(!this->done.load(std::memory_order_acquire))
+		std::this_thread::yield();
+}
+
+#undef self
+#undef constructor
@@ -0,0 +1,4 @@
+#pragma once
+#include <async/stop/fwd.h>
+#include <async/stop/decl.h>
+#include <async/stop/impl.h>
@@ -1,19 +1,40 @@
 #pragma once
 #include <async/stream/fwd.h>
+#include <async/stream/options.h>
+#include <async/executor/fwd.h>
+#include <async/queue/fwd.h>
+#include <async/batch/decl.h>
+#include <async/pipeline/fwd.h>
+#include <async/function/decl.h>
+#include <async/rcu/decl.h>
+#include <async/stop/decl.h>
+#include <async/completion/decl.h>
+#include <async/timer/decl.h>
 #include <type_traits>
 #include <atomic>
 #include <functional>
 #include <vector>
 #include <stdexcept>
 #include <mutex>
+#include <condition_variable>
+#include <cstddef>
 #include <memory>
 
+#ifdef ASYNC_STREAM_METRICS
+#include <async/metrics/decl.h>
+#include <iosfwd>
+#include <string>
+#endif
+
 /**
  * A class that represents an asynchronous data flow/stream
  * @tparam T The type of data that flows in this stream
  */
 template <class T>
 class async::stream{
+	template <class>
+	friend class async::stream;
+
 	public:
 		using value_type = typename std::decay<T>::type;///< @typedef value_type being the type of value flowing into this stream
 		using mutex_type = std::mutex;///< @typedef mutex_type being the type of mutex used to lock the stream
@@ -21,26 +42,233 @@ class async::stream{
 		using stream_type = async::stream<T>;///< @typedef stream_type being the type of this stream
 		using done_flag = std::atomic_bool;///< @typedef done_flag being the type of the a flag for a completable action
 
-		using listener_type = std::function<void(const value_type&)>;///< @typedef listener_type being the type of listeners used to handle new data
-		using listener_storage_type = std::vector<listener_type>;///< @typedef listener_storage_type being the type of the container used to store listeners
+		using shared_value = std::shared_ptr<const value_type>;///< @typedef shared_value being the type of the immutable, reference counted values flowing into this stream
+		using batch_type = async::batch<value_type>;///< @typedef batch_type being the type of the runs of values emitted at once
+		using shared_batch = std::shared_ptr<const batch_type>;///< @typedef shared_batch being the type of the immutable, reference counted batches flowing into this stream
+		using span_type = async::span<const value_type>;///< @typedef span_type being the type of view over contiguous values handed to batch listeners
+
+		using listener_type = async::inplace_function<void(const value_type&)>;///< @typedef listener_type being the type of listeners used to handle new data
+		using shared_listener_type = async::inplace_function<void(const shared_value&)>;///< @typedef shared_listener_type being the type of listeners that share ownership of the values they receive
+		using batch_listener_type = async::inplace_function<void(span_type)>;///< @typedef batch_listener_type being the type of listeners that handle contiguous values at once
+		using shared_batch_listener_type = async::inplace_function<void(const shared_batch&)>;///< @typedef shared_batch_listener_type being the type of listeners that share ownership of the batches they receive
+
+		using subscription_type = std::size_t;///< @typedef subscription_type being the type of handles used to remove listeners
+
+		/**
+		 * A registered listener, whichever callbacks are set tell how it prefers to receive values
+		 */
+		struct listener_entry{
+			subscription_type id = 0;///< @property id being the handle of this listener
+			listener_type value;///< @property value being the callback for a single value
+			shared_listener_type shared;///< @property shared being the callback for a single shared value
+			batch_listener_type span;///< @property span being the callback for contiguous values
+			shared_batch_listener_type batch;///< @property batch being the callback for a shared batch
+		};
+
+		/**
+		 * A listener as stored in the registry, deactivated as soon as it is removed
+		 */
+		struct registered_listener{
+			listener_entry entry;///< @property entry being the listener
+			mutable std::atomic_bool active{true};///< @property active being whether or not the listener has not been removed yet
+
+			#ifdef ASYNC_STREAM_METRICS
+			mutable async::metrics::histogram duration{};///< @property duration being how long the listener takes for each value or batch
+			#endif
+
+			explicit registered_listener(listener_entry&& entry) : entry(std::move(entry)){}
+		};
+
+		using listener_storage_type = std::vector<std::shared_ptr<const registered_listener>>;///< @typedef listener_storage_type being the type of the container used to store listeners (shared between snapshots since listeners are move-only)
+		using listener_registry = async::rcu_cell<listener_storage_type>;///< @typedef listener_registry being the type of the registry publishing immutable sets of listeners to deliveries
 
 		using exception = std::runtime_error;///< @typedef exception being the type of exception thrown when an unexpected error occurs
 		using shared_stream = std::shared_ptr<stream_type>;///< @typedef shared_stream being the type that designates a shared pointer to a stream
 
-		using close_listener_type = std::function<void()>;///< @typedef close_listener_type being the type of listeners used when the stream is closed
-		using close_listener_storage_type = std::vector<close_listener_type>;///< @typedef close_listener_storage_type being the type of the container used to store on close listeners
+		using close_listener_type = async::inplace_function<void()>;///< @typedef close_listener_type being the type of listeners used when the stream is closed
+		using close_listener_storage_type = std::vector<std::shared_ptr<close_listener_type>>;///< @typedef close_listener_storage_type being the type of the container used to store on close listeners (shared between copies of the stream)
+
+		using shared_executor = async::shared_executor;///< @typedef shared_executor being the type of executor used to deliver values
+		using options_type = async::stream_options;///< @typedef options_type being the type of the settings of this stream
+
+		/**
+		 * What the delivery queue holds: either a single value or a batch
+		 */
+		struct envelope{
+			shared_value value;///< @property value being the single value (if any)
+			shared_batch batch;///< @property batch being the batch of values (if any)
+
+			#ifdef ASYNC_STREAM_METRICS
+			std::uint64_t enqueued = 0;///< @property enqueued being when the value or batch has been emitted (see async::metrics::now)
+			#endif
+		};
+
+		using stop_source = async::stop_source;///< @typedef stop_source being the type of cancellation source shared by a stream and the streams derived from it
+		using stop_token = async::stop_token;///< @typedef stop_token being the type of token used to check for a stop request
+
+		using queue_type = async::delivery_queue<envelope>;///< @typedef queue_type being the type of queue that holds the values awaiting delivery
+		using queue_ptr = std::unique_ptr<queue_type>;///< @typedef queue_ptr being the type of pointer to the delivery queue
+
+		using window_type = std::vector<value_type>;///< @typedef window_type being the type of the groups of values emitted by async::stream<T>::window
+		using shared_window_stream = std::shared_ptr<async::stream<window_type>>;///< @typedef shared_window_stream being the type of stream of windows
+		using duration = async::timer::duration;///< @typedef duration being the type of the lengths of time-based windows
 
 	protected:
 		mutex_type mutex{};///< @property mutex being the mutex used to lock the stream
 		done_flag closed{false};///< @property closed being the flag used to determine whether or not this stream is closed
-		listener_storage_type listeners{};///< @property listeners being the container of value listeners
+		listener_registry listeners{};///< @property listeners being the container of value listeners (copied on write, read without locking)
+		stop_source stopper{};///< @property stopper being the source of the stop requests (shared with the task and the derived streams)
+		std::atomic<subscription_type> nextSubscription{1};///< @property nextSubscription being the handle given to the next listener
 		close_listener_storage_type closeListeners{};///< @property closeListeners being the container of on close listeners
+		bool closeNotified = false;///< @property closeNotified being the flag determining whether or not the close listeners have been run (locked by mutex)
+
+		options_type opts;///< @property opts being the settings of this stream
+		shared_executor executor_ptr;///< @property executor_ptr being the executor that runs the deliveries of this stream
+		queue_ptr queue;///< @property queue being the values awaiting delivery
+		std::atomic<std::size_t> emitting{0};///< @property emitting being the amount of values currently being pushed in the queue
+		std::atomic<std::size_t> drainers{0};///< @property drainers being the amount of deliveries scheduled or running
+		std::atomic_bool completing{false};///< @property completing being the flag determining whether or not a delivery is running the close listeners
+		std::size_t maxDrainers = 1;///< @property maxDrainers being the maximum amount of deliveries running at once
+		std::atomic<std::size_t> droppedCount{0};///< @property droppedCount being the amount of values discarded by the overflow policy
+
+		mutable mutex_type stateMutex{};///< @property stateMutex being the mutex used to wait for room in the queue
+		mutable std::condition_variable stateCv{};///< @property stateCv being the condition variable used to wait for room in the queue
+		std::atomic<std::size_t> blockedProducers{0};///< @property blockedProducers being the amount of producers waiting for room in the queue
+		std::shared_ptr<async::completion> completed{new async::completion{}};///< @property completed being the event signaled once the close listeners have been run
+
+		#ifdef ASYNC_STREAM_METRICS
+		/**
+		 * The instruments of a stream, updated by its producers and deliveries
+		 */
+		struct metrics_type{
+			async::metrics::counter emitted{};///< @property emitted being the amount of values emitted
+			async::metrics::counter delivered{};///< @property delivered being the amount of values handed to the listeners
+			async::metrics::counter blocked{};///< @property blocked being the amount of emits that waited for room in the queue
+			async::metrics::histogram dispatch{};///< @property dispatch being the time values spend in the queue
+			std::atomic<std::size_t> maxDepth{0};///< @property maxDepth being the largest depth seen by a delivery
+		};
+
+		using metrics_dump_type = std::function<void(std::ostream&, const std::string&)>;///< @typedef metrics_dump_type being the type of functions printing the metrics of a derived stream (if it still exists)
+
+		std::unique_ptr<metrics_type> stats{new metrics_type{}};///< @property stats being the instruments of this stream
+		mutable std::vector<metrics_dump_type> derivedDumps{};///< @property derivedDumps being the functions printing the metrics of the streams derived from this one (locked by stateMutex)
+		#endif
+
+		/**
+		 * Push a value in the delivery queue according to the overflow policy
+		 * @param value being the value to push
+		 */
+		void enqueue(envelope& item);
+
+		/**
+		 * Register a listener
+		 * @param entry being the listener to register
+		 * @return a reference to this stream
+		 */
+		stream_type& addEntry(listener_entry entry);
+
+		/**
+		 * Register a listener
+		 * @param entry being the listener to register
+		 * @return the handle of the listener
+		 */
+		subscription_type subscribeEntry(listener_entry entry);
+
+		/**
+		 * Hand a value or a batch to a listener, in the form it prefers
+		 * @param entry being the listener
+		 * @param item being what to deliver
+		 */
+		static void dispatch(const listener_entry& entry, const envelope& item);
+
+		/**
+		 * Schedule a delivery on the executor unless enough of them are already scheduled or running
+		 */
+		void schedule();
+
+		/**
+		 * Reserve a delivery slot if there is one left
+		 * @return TRUE if a slot has been reserved, FALSE otherwise
+		 */
+		bool acquire_drainer();
+
+		/**
+		 * Deliver the pending values (in order unless there are concurrent deliveries), then run the close listeners if the stream has been closed
+		 */
+		void drain();
+
+		/**
+		 * Deliver a burst of pending values to the listeners
+		 * @return TRUE if at least one value has been delivered, FALSE if the queue was empty
+		 */
+		bool deliver();
+
+		/**
+		 * Poll the empty queue for a while before parking the delivery
+		 * @return TRUE if there is something left to do, FALSE if the delivery can park
+		 */
+		bool idle_wait() const;
+
+		/**
+		 * @property DELIVERY_BURST The maximum amount of values delivered with the same snapshot of listeners
+		 */
+		static constexpr std::size_t DELIVERY_BURST = 64;
+
+		/**
+		 * Wake up the producers waiting for room in the queue, if any
+		 */
+		void notify_producers();
+
+		/**
+		 * Create the delivery queue described by the options
+		 * @param options being the settings of the stream
+		 * @return the created queue
+		 */
+		static queue_ptr make_queue(const options_type& options);
+
+		/**
+		 * Take the settings of another stream, but for the ones the queue was built from (it may hold values awaiting delivery)
+		 * @param options being the settings to take
+		 * @post the mode, capacity, overflow policy, concurrency and resource still describe the queue of this stream
+		 */
+		void assign_options(const options_type& options);
+
+		/**
+		 * Construct a shared value from the given arguments, from the resource of this stream (if any)
+		 * @tparam Args - The types of the arguments used in order to create the new data
+		 * @param args - The arguments used to construct the new value (see async::stream<T>::make_value)
+		 * @return the newly allocated value
+		 */
+		template <class... Args>
+		shared_value allocate_value(Args&&... args) const;
+
+		/**
+		 * Construct a shared batch from the given arguments, from the resource of this stream (if any)
+		 * @tparam Args - The types of the arguments used in order to create the batch
+		 * @param args - The arguments of the constructor of the batch
+		 * @return the newly allocated batch
+		 * @warning only the batch itself comes from the resource, the storage of its values does not
+		 */
+		template <class... Args>
+		shared_batch allocate_batch(Args&&... args) const;
 
 	public:
 		/**
-		 * Default constructor that initializes a stream to a valid state
+		 * Default constructor that initializes a stream to a valid state (uses async::default_executor)
 		 */
-		stream() = default;
+		stream();
+
+		/**
+		 * Construct a stream that delivers its values on the given executor
+		 * @param executor being the executor used to deliver values to the listeners
+		 */
+		explicit stream(shared_executor executor);
+
+		/**
+		 * Construct a stream from its settings
+		 * @param options being the settings of this stream (executor, queue capacity, overflow policy)
+		 */
+		explicit stream(const options_type& options);
 
 		/**
 		 * Copy constructor
@@ -56,9 +284,9 @@ class async::stream{
 		stream(stream_type&& other) noexcept;
 
 		/**
-		 * Destructor
+		 * Destructor, closes the stream and waits for the pending values to be delivered
 		 */
-		~stream(){ this->close(); }
+		~stream();
 
 		/**
 		 * Copy assignment
@@ -87,6 +315,41 @@ class async::stream{
 		stream_type& onValue(listener_type);
 		/** @} */
 
+		/**
+		 * Listen to the data coming into the stream without copying it (used to forward values to other streams)
+		 * @param listener being the listener that will receive each new value
+		 * @return a reference to this stream
+		 */
+		stream_type& onShared(shared_listener_type listener);
+
+		/**
+		 * Listen to the data coming into the stream by runs of contiguous values (single values come as a run of one)
+		 * @param listener being the listener that will receive each batch of values
+		 * @return a reference to this stream
+		 */
+		stream_type& onBatch(batch_listener_type listener);
+
+		/**
+		 * @defgroup subscriptions
+		 * @{
+		 * Listen to the data coming into the stream (like async::stream<T>::onValue, async::stream<T>::onShared and async::stream<T>::onBatch)
+		 * @param listener being the listener to register
+		 * @return the handle to give to async::stream<T>::removeListener
+		 */
+		subscription_type subscribe(listener_type listener);
+		subscription_type subscribeShared(shared_listener_type listener);
+		subscription_type subscribeBatch(batch_listener_type listener);
+		/** @} */
+
+		/**
+		 * Stop listening to the data coming into the stream
+		 * @param subscription being the handle of the listener to remove
+		 * @return TRUE if the listener has been removed, FALSE if there was no such listener
+		 *
+		 * @post The listener no longer receives values, except for the one it may be handling at the moment
+		 */
+		bool removeListener(subscription_type subscription);
+
 		/**
 		 * @defgroup emitting
 		 * @{
@@ -95,12 +358,48 @@ class async::stream{
 		 * @return a reference to this stream
 		 *
 		 * @pre This stream is not closed
-		 * @post The value has been emitted
+		 * @post The value has been queued for delivery (or handled according to the overflow policy)
+		 * @throws async::stream<T>::exception if the queue is full and the overflow policy is async::overflow_policy::fail
 		 */
 		stream_type& emit(const value_type& value);
+		stream_type& emit(value_type&& value);
 		stream_type& operator<<(const value_type& value);
+		stream_type& operator<<(value_type&& value);
 		/**  @} */
 
+		/**
+		 * Push an already shared value down the stream, the value is neither copied nor moved
+		 * @param value being the value to push down the stream
+		 * @return a reference to this stream
+		 *
+		 * @pre This stream is not closed, value is not null
+		 * @post The value has been queued for delivery (or handled according to the overflow policy)
+		 * @throws async::stream<T>::exception if the queue is full and the overflow policy is async::overflow_policy::fail
+		 */
+		stream_type& emitShared(shared_value value);
+		stream_type& emitShared(shared_batch values);
+
+		/**
+		 * @defgroup batching
+		 * @{
+		 * Push several values down the stream at once, they go through the queue and the listeners as a single batch
+		 * @param values being the values to push down the stream (copied, or moved out of an rvalue vector)
+		 * @return a reference to this stream
+		 *
+		 * @pre This stream is not closed
+		 * @post The batch has been queued for delivery (or handled according to the overflow policy), empty batches are ignored
+		 * @throws async::stream<T>::exception if the queue is full and the overflow policy is async::overflow_policy::fail
+		 * @warning a batch takes a single slot in the delivery queue
+		 */
+		template <class Range>
+		stream_type& emitBatch(const Range& values);
+
+		stream_type& emitBatch(std::vector<value_type>&& values);
+
+		template <class Iterator>
+		stream_type& emitBatch(Iterator first, Iterator last);
+		/** @} */
+
 		/**
 		 * Interoperability with pointers to streams
 		 * @return a pointer to this stream
@@ -108,20 +407,30 @@ class async::stream{
 		stream_type* operator->(){ return this; }
 
 		/**
-		 * Construct the next value to be pushed down the stream and pushes it
+		 * Construct the next value to be pushed down the stream (in place, forwarding the arguments) and pushes it
 		 * @tparam Args - The types of the arguments used in order to create the new data
 		 * @param args - The arguments used to construct the new value
 		 * @return a reference to this stream
 		 *
 		 * @pre This stream is not closed
-		 * @post The value has been emitted
+		 * @post The value has been queued for delivery (or handled according to the overflow policy)
+		 * @throws async::stream<T>::exception if the queue is full and the overflow policy is async::overflow_policy::fail
 		 */
 		template <class... Args>
 		stream_type& emit(Args&&... args);
 
+		/**
+		 * Construct a shared value from the given arguments
+		 * @tparam Args - The types of the arguments used in order to create the new data
+		 * @param args - The arguments used to construct the new value (braced initialization is used if no constructor matches)
+		 * @return the newly allocated value
+		 */
+		template <class... Args>
+		static shared_value make_value(Args&&... args);
+
 		/**
 		 * Add a callback to be executed when the stream is closed
-		 * @param listener - The listener that will be executed once the stream is closed
+		 * @param listener - The listener that will be executed once the stream is closed (right away if the close listeners have already been run)
 		 * @return a reference to this stream
 		 */
 		stream_type& onClose(close_listener_type listener);
@@ -136,13 +445,72 @@ class async::stream{
 		stream_type& close();
 
 		/**
-		 * Waits until the stream is closed
+		 * Waits until the stream is closed and every value has been delivered
 		 * @warning introduces a blocking call
 		 *
 		 * @post The stream is closed
 		 */
 		void wait() const;
 
+		/**
+		 * Get the event signaled once the stream is closed and every value has been delivered
+		 * @return a shared_ptr to the event (it outlives the stream), supports timed waits
+		 */
+		async::shared_completion completion() const{ return this->completed; }
+
+		/**
+		 * Get the executor that runs the deliveries of this stream
+		 * @return a shared_ptr to the executor of this stream
+		 */
+		shared_executor executor() const{ return this->executor_ptr; }
+
+		/**
+		 * Get the timer used by the time-based operators of this stream (eg. async::stream<T>::window)
+		 * @return a shared_ptr to the timer of this stream (async::default_timer if the options do not give one)
+		 */
+		async::shared_timer timer() const{ return this->opts.timer ? this->opts.timer : async::default_timer(); }
+
+		/**
+		 * Get the settings of this stream
+		 * @return the options this stream has been constructed with
+		 */
+		const options_type& options() const{ return this->opts; }
+
+		/**
+		 * Get the amount of values awaiting delivery
+		 * @return the current depth of the delivery queue
+		 */
+		std::size_t depth() const;
+
+		/**
+		 * Get the maximum amount of values awaiting delivery
+		 * @return the capacity of the delivery queue (async::stream_options::UNBOUNDED if not bounded)
+		 */
+		std::size_t capacity() const;
+
+		/**
+		 * Get the amount of values discarded because the delivery queue was full
+		 * @return the amount of dropped values
+		 */
+		std::size_t dropped() const{ return this->droppedCount.load(); }
+
+		#ifdef ASYNC_STREAM_METRICS
+		/**
+		 * Take a snapshot of the metrics of this stream (only available when ASYNC_STREAM_METRICS is defined)
+		 * @return the counters and latency histograms of this stream and of its listeners
+		 */
+		async::metrics::stream_snapshot metrics() const;
+
+		/**
+		 * Print the metrics of this stream and of every stream derived from it (eg. through filter or map), depth first
+		 * (only available when ASYNC_STREAM_METRICS is defined)
+		 * @param out being the stream to print to
+		 * @param name being the name this stream is printed under (derived streams are named after it, eg. "stream.0.1")
+		 * @return out
+		 */
+		std::ostream& dumpMetrics(std::ostream& out, const std::string& name = "stream") const;
+		#endif
+
 	public:
 		/**
 		 * Pipes a stream to this stream (functions like "ls | grep" in bash)
@@ -176,6 +544,132 @@ class async::stream{
 		std::shared_ptr<stream<U>> mapTo(Mapper mapper);
 		/** @} */
 
+		/**
+		 * Maps the values of this stream that can be mapped, in a single stage (eg. validate and parse)
+		 * @tparam U - The type of data that will flow in the mapped stream
+		 * @tparam Parser - Parser :: (const value_type&, U&) -> bool
+		 * @param parser - The function that stores the mapped value in its second argument, returns false to drop the value
+		 * @return a shared_ptr to the mapped stream
+		 */
+		template <class U, class Parser>
+		std::shared_ptr<stream<U>> filterMap(Parser parser);
+
+		/**
+		 * Maps this stream into a stream of another type, running the mapper on several values at once
+		 * @tparam U - The type of data that will flow in the mapped stream
+		 * @tparam Mapper - Mapper :: (const value_type&) -> U
+		 * @param mapper - The mapper function used to map each incoming element (invoked concurrently)
+		 * @param concurrency - The maximum amount of values mapped at once (0 means the concurrency of the executor of this stream)
+		 * @param ordered - Whether the mapped values are emitted in input order (through a reorder buffer) or as soon as they are ready
+		 * @return a shared_ptr to the mapped stream
+		 *
+		 * @warning At most 4 * concurrency values are in flight, the delivery of this stream waits for room beyond that
+		 * @warning Values the mapper throws on are skipped
+		 */
+		template <class U, class Mapper>
+		std::shared_ptr<stream<U>> parallelMap(Mapper mapper, std::size_t concurrency = 0, bool ordered = true);
+
+		/**
+		 * Group the values of this stream by count: a window of size values starts every step values
+		 * (tumbling windows if step is size, sliding windows if it is smaller)
+		 * @param size - The amount of values of a window
+		 * @param step - The amount of values between the starts of two windows (0 means size)
+		 * @return a shared_ptr to the stream of windows
+		 *
+		 * @throws async::stream<T>::exception if size is 0
+		 * @post Once this stream is closed, the windows that have started are emitted with the values they have, then the stream of windows is closed
+		 */
+		shared_window_stream window(std::size_t size, std::size_t step = 0);
+
+		/**
+		 * Group the values of this stream by arrival time: every step, the values received during the last size are emitted
+		 * (tumbling windows if step is size, sliding windows if it is smaller)
+		 * @param size - The length of a window
+		 * @param step - The delay between the ends of two windows (0 means size)
+		 * @return a shared_ptr to the stream of windows
+		 *
+		 * @throws async::stream<T>::exception if size is not positive
+		 * @warning Windows are ended by the timer of this stream (see async::stream_options::withTimer) and emitted from its executor, empty windows are skipped
+		 * @post Once this stream is closed, the values received since the last window are emitted, then the stream of windows is closed
+		 */
+		shared_window_stream window(duration size, duration step = duration::zero());
+
+		/**
+		 * @defgroup windowReduce
+		 * @{
+		 * Aggregate the values of this stream by tumbling windows (of a count of values, or of a duration), each value is folded as
+		 * it arrives so that no window is kept in memory
+		 * @tparam Reducer - Reducer :: (Accumulator, const value_type&) -> Accumulator
+		 * @tparam Accumulator - The type of the aggregate of a window
+		 * @param size - The amount of values or the length of a window
+		 * @param reducer - The function used to fold a value into the aggregate of its window
+		 * @param identity - The aggregate of an empty window
+		 * @return a shared_ptr to the stream of aggregates
+		 *
+		 * @throws async::stream<T>::exception if size is 0 (or not positive)
+		 * @warning Time-based windows are ended by the timer of this stream and emitted from its executor, empty windows are skipped
+		 * @post Once this stream is closed, the aggregate of the current window is emitted (unless it is empty), then the stream of aggregates is closed
+		 */
+		template <class Reducer, class Accumulator>
+		std::shared_ptr<stream<Accumulator>> windowReduce(std::size_t size, Reducer reducer, Accumulator identity);
+
+		template <class Reducer, class Accumulator>
+		std::shared_ptr<stream<Accumulator>> windowReduce(duration size, Reducer reducer, Accumulator identity);
+		/** @} */
+
+		/**
+		 * Let a value through, then drop the values that arrive during the given interval (leading edge throttling)
+		 * @param interval - The minimum delay between two values of the throttled stream
+		 * @return a shared_ptr to the throttled stream
+		 *
+		 * @throws async::stream<T>::exception if interval is not positive
+		 * @warning Values are not delayed, so throttling needs no timer
+		 */
+		shared_stream throttle(duration interval);
+
+		/**
+		 * Emit a value once no other value has followed it for the given quiet period (the last value of each burst)
+		 * @param quiet - How long no value must arrive for the latest one to be emitted
+		 * @return a shared_ptr to the debounced stream
+		 *
+		 * @throws async::stream<T>::exception if quiet is not positive
+		 * @warning The timer of this stream is used at most once per quiet period, not once per value
+		 * @post Once this stream is closed, the value waiting for the quiet period (if any) is emitted, then the debounced stream is closed
+		 */
+		shared_stream debounce(duration quiet);
+
+		/**
+		 * Emit the latest value of this stream periodically (nothing is emitted if no value has arrived since the last sample)
+		 * @param period - The delay between two samples
+		 * @return a shared_ptr to the sampled stream
+		 *
+		 * @throws async::stream<T>::exception if period is not positive
+		 * @post Once this stream is closed, the value received since the last sample (if any) is emitted, then the sampled stream is closed
+		 */
+		shared_stream sample(duration period);
+
+		/**
+		 * Forward the values of this stream until none arrives within the given time limit, the guarded stream is then closed
+		 * @param limit - How long without a value is tolerated (measured from the call, then from the latest value)
+		 * @param onTimeout - A function invoked once the time limit has been exceeded (eg. to call async::stream<T>::requestStop)
+		 * @return a shared_ptr to the guarded stream
+		 *
+		 * @throws async::stream<T>::exception if limit is not positive
+		 * @warning The values that arrive after the time limit has been exceeded are dropped
+		 */
+		shared_stream timeout(duration limit, std::function<void()> onTimeout = nullptr);
+
+		/**
+		 * Emit each value of this stream after the given delay (the order of the values is kept)
+		 * @param lag - The delay of each value
+		 * @return a shared_ptr to the delayed stream
+		 *
+		 * @throws async::stream<T>::exception if lag is not positive
+		 * @warning A single tick of the timer is pending per stream at any time, not one per value
+		 * @post Once this stream is closed, the delayed stream is closed as soon as the values it holds have been emitted
+		 */
+		shared_stream delay(duration lag);
+
 		/**
 		 * Invoke a function on each element of this stream
 		 * @param listener being the function to invoke on each element
@@ -189,6 +683,15 @@ class async::stream{
 		 */
 		void forEach(listener_type listener);
 
+		/**
+		 * Start a fused pipeline on this stream: its stages are composed at compile time and attached as a single listener,
+		 * no intermediate stream is created in between
+		 * @return an empty pipeline listening to this stream
+		 *
+		 * @warning This stream must outlive the pipeline until a terminal operation attaches it
+		 */
+		async::pipeline<T, T, async::fused::identity> fuse();
+
 		/**
 		 * Reduces the stream to a single value
 		 * @tparam Reducer - Reducer :: (Accumulator, const value_type&) -> Accumulator
@@ -203,41 +706,108 @@ class async::stream{
 		template <class Reducer, class Accumulator>
 		Accumulator reduce(Reducer, Accumulator);
 
+		/**
+		 * Reduces the stream to a single value, each thread delivering values folds them into its own partial accumulator
+		 * @tparam Reducer - Reducer :: (Accumulator, const value_type&) -> Accumulator
+		 * @tparam Combiner - Combiner :: (Accumulator, Accumulator) -> Accumulator
+		 * @tparam Accumulator - The type of the final desired value
+		 * @param reducer - The function used to fold a value into a partial accumulator
+		 * @param combiner - The function used to merge two partial accumulators once the stream is closed
+		 * @param identity - The value each partial accumulator starts from (must not change the result when combined)
+		 * @return the reduced value
+		 *
+		 * @warning This is a blocking call that waits until this stream is closed
+		 * @warning Values are only folded in order (into a single accumulator) if this stream delivers them in order
+		 * @post The stream is closed
+		 */
+		template <class Reducer, class Combiner, class Accumulator>
+		Accumulator reduce(Reducer reducer, Combiner combiner, Accumulator identity);
+
+		/**
+		 * Collects the values of this stream into a container
+		 * @tparam Container - The type of container to collect into (must support insert(end(), value))
+		 * @return the container of every value of this stream (in order if this stream delivers them in order)
+		 *
+		 * @warning This is a blocking call that waits until this stream is closed
+		 * @post The stream is closed
+		 */
+		template <class Container = std::vector<T>>
+		Container collect();
+
 		/**
 		 * Tests whether or not any element of this stream matches the given predicate
 		 * @tparam Predicate - Predicate :: (const value_type&) -> bol
 		 * @param predicate - The predicate to match against each element
+		 * @param stopUpstream - Whether or not to ask the producer to stop once the result is known (see async::stream<T>::requestStop)
 		 * @return true if any matches, false if none
 		 *
-		 * @warning Uses async::stream<T>::reduce and therefore introduces a blocking call
-		 * @post The stream is closed
+		 * @warning This is a blocking call that waits until the first match or until this stream is closed
+		 * @post The result is known, the predicate is not invoked anymore
 		 */
 		template <class Predicate>
-		bool anyMatch(Predicate);
+		bool anyMatch(Predicate predicate, bool stopUpstream = false);
 
 		/**
 		 * Tests whether or not every element of this stream matches the given predicate
 		 * @tparam Predicate - Predicate :: (const value_type&) -> bool
 		 * @param predicate - The predicate to match
+		 * @param stopUpstream - Whether or not to ask the producer to stop once the result is known (see async::stream<T>::requestStop)
 		 * @return true if every element matches, false otherwise
 		 *
-		 * @warning Uses async::stream<T>::reduce and therefore introduces a blocking call
-		 * @post The stream is closed
+		 * @warning This is a blocking call that waits until the first mismatch or until this stream is closed
+		 * @post The result is known, the predicate is not invoked anymore
 		 */
 		template <class Predicate>
-		bool allMatch(Predicate);
+		bool allMatch(Predicate predicate, bool stopUpstream = false);
 
 		/**
 		 * Tests whether or not none of this stream's element
 		 * @tparam Predicate - Predicate :: (const value_type&) -> bool
 		 * @param predicate - The predicate to test against
+		 * @param stopUpstream - Whether or not to ask the producer to stop once the result is known (see async::stream<T>::requestStop)
 		 * @return true if none matches, false otherwise
 		 *
-		 * @warning Uses async::stream<T>::reduce and therefore introduces a blocking call
-		 * @post The stream is closed
+		 * @warning This is a blocking call that waits until the first match or until this stream is closed
+		 * @post The result is known, the predicate is not invoked anymore
 		 */
 		template <class Predicate>
-		bool noneMatch(Predicate);
+		bool noneMatch(Predicate predicate, bool stopUpstream = false);
+
+		/**
+		 * Ask the producer of this stream (and of the streams it derives from) to stop emitting values
+		 * @return a reference to this stream
+		 *
+		 * @warning This is a request: producers are expected to check async::stream<T>::stopRequested, values still emitted are delivered
+		 * @warning The request reaches every stream derived from the same source
+		 * @post Producers blocked on a full queue give up on their value (counted as dropped) within a few milliseconds
+		 */
+		stream_type& requestStop();
+
+		/**
+		 * Determine whether or not the producer has been asked to stop (a single atomic load, cheap enough for the producer's loop)
+		 * @return TRUE if a stop has been requested on this stream or on a stream derived from the same source
+		 */
+		bool stopRequested() const{ return this->stopper.stop_requested(); }
+
+		/**
+		 * Get the source of the stop requests of this stream, to cancel the pipeline from anywhere
+		 * @return the source shared with the task and the derived streams
+		 */
+		stop_source stopSource() const{ return this->stopper; }
+
+		/**
+		 * Get a token to check for or react to a stop request (see async::stop_callback)
+		 * @return a token associated to the source of this stream
+		 */
+		stop_token stopToken() const{ return this->stopper.get_token(); }
+
+		/**
+		 * Create an empty stream meant to receive values derived from this one (used by operators such as filter or map)
+		 * @tparam U - The type of data that will flow in the derived stream
+		 * @return a shared_ptr to a stream with the same options, sharing the stop requests of this one
+		 */
+		template <class U = T>
+		std::shared_ptr<async::stream<U>> derive() const;
 
 	public:
 		/**
@@ -245,6 +815,26 @@ class async::stream{
 		 */
 		static constexpr const char* const ERR_STREAM_CLOSED = "Cannot emit a new value, the stream has already been closed";
 
+		/**
+		 * @property ERR_STREAM_FULL The error message used when a value is emitted while the delivery queue is full
+		 */
+		static constexpr const char* const ERR_STREAM_FULL = "Cannot emit a new value, the delivery queue of the stream is full";
+
+		/**
+		 * @property ERR_UNSUPPORTED_OVERFLOW The error message used when the overflow policy cannot be honored by the queue mode
+		 */
+		static constexpr const char* const ERR_UNSUPPORTED_OVERFLOW = "The overflow policy is not supported by the queue mode of the stream";
+
+		/**
+		 * @property ERR_EMPTY_WINDOW The error message used when a window would not hold any value
+		 */
+		static constexpr const char* const ERR_EMPTY_WINDOW = "Cannot group values in windows of size 0";
+
+		/**
+		 * @property ERR_NON_POSITIVE_DURATION The error message used when a time-based operator is given a duration that is not positive
+		 */
+		static constexpr const char* const ERR_NON_POSITIVE_DURATION = "Time-based operators need a positive duration";
+
 		/**
 		 * Creates a stream using the given arguments
 		 * @tparam T The type of data that flows in this stream
@@ -1,35 +1,89 @@
 #pragma once
 #include <async/stream/decl.h>
+#include <async/executor/executor.hpp>
 #include <utility>
-#include <future>
 #include <algorithm>
 #include <functional>
 #include <memory>
 #include <condition_variable>
+#include <async/queue/queue.hpp>
+#include <async/memory/memory.hpp>
+#include <async/batch/batch.hpp>
+#include <async/pipeline/pipeline.hpp>
+#include <async/function/function.hpp>
+#include <async/rcu/rcu.hpp>
+#include <async/stop/stop.hpp>
+#include <async/completion/completion.hpp>
+#include <async/stream/parallel_map.h>
+#include <async/stream/reduce.h>
+#include <async/stream/window.h>
+#include <async/stream/timing.h>
+#include <async/timer/timer.hpp>
+#include <thread>
+#include <chrono>
+#include <type_traits>
+
+#ifdef ASYNC_STREAM_METRICS
+#include <async/metrics/metrics.hpp>
+#include <ostream>
+#endif
+
+#ifdef ASYNC_TRACE
+#include <async/trace/trace.hpp>
+#endif
 
 #define TPL template <class T>
 #define constructor stream
 #define self async::stream<T>
 #define self_t typename self
 #define LOCK self_t::lock_guard _{this->mutex};
+#define STATE_LOCK self_t::lock_guard _s{this->stateMutex};
 #define IF_CLOSED_THROW if(this->closed.load())\
   throw self_t::exception(self::ERR_STREAM_CLOSED);
 
 TPL
-self::constructor(const self_t::stream_type& other) : constructor() {
+self::constructor() : constructor(self_t::options_type{}) {
+}
+
+TPL
+self::constructor(self_t::shared_executor executor) : constructor(self_t::options_type{}.withExecutor(std::move(executor))) {
+}
+
+TPL
+self::constructor(const self_t::options_type& options)
+: opts{options}, executor_ptr{options.executor ? options.executor : async::default_executor()}, queue{self::make_queue(options)} {
+	if(options.mode == async::queue_mode::mpmc && options.concurrency > 1)
+		this->maxDrainers = options.concurrency;
+}
+
+TPL
+self::constructor(const self_t::stream_type& other) : constructor(other.opts) {
 	*this = other;
 }
 
 TPL
-self::constructor(self_t::stream_type&& other) noexcept : constructor() {
+self::constructor(self_t::stream_type&& other) noexcept : constructor(other.opts) {
 	*this = std::forward<decltype(other)>(other);
 }
 
+TPL
+self::~constructor(){
+	this->close();
+	this->wait();
+}
+
 TPL
 self/*_t::stream_type*/& self::operator=(const self_t::stream_type& other){
 	this->closed.store(other.closed.load());
-	this->listeners = other.listeners;
+	this->listeners.store(*other.listeners.read());
 	this->closeListeners = other.closeListeners;
+	this->executor_ptr = other.executor_ptr;
+	this->assign_options(other.opts);
+	this->stopper = other.stopper;
+
+	if(this->closed.load())
+		this->completed->complete();
+
 	return *this;
 }
 
@@ -46,107 +100,595 @@ constexpr self_t::stream_type self::make(){
 	return self::from();
 }
 
+TPL
+self_t::queue_ptr self::make_queue(const self_t::options_type& options){
+	const auto capacity = options.capacity == options_type::UNBOUNDED ? options_type::DEFAULT_CAPACITY : options.capacity;
+
+	switch(options.mode){
+		case async::queue_mode::spsc:
+			if(options.overflow == async::overflow_policy::drop_oldest)
+				throw self_t::exception(self::ERR_UNSUPPORTED_OVERFLOW);
+
+			return self_t::queue_ptr{new async::spsc_queue<self_t::envelope>(capacity)};
+
+		case async::queue_mode::mpmc:
+			return self_t::queue_ptr{new async::mpmc_queue<self_t::envelope>(capacity)};
+
+		case async::queue_mode::locked:
+		default:
+			return self_t::queue_ptr{new async::locked_queue<self_t::envelope>(options.capacity, options.resource)};
+	}
+}
+
+TPL
+void self::assign_options(const self_t::options_type& options){
+	const auto shape = this->opts;
+	this->opts = options;
+	this->opts.mode = shape.mode;
+	this->opts.capacity = shape.capacity;
+	this->opts.overflow = shape.overflow;
+	this->opts.concurrency = shape.concurrency;
+	this->opts.resource = shape.resource;
+}
+
 TPL
 self& self::operator=(self_t::stream_type&& other) noexcept{
 	this->closed.store(other.closed.load());
-	this->listeners = std::move(other.listeners);
+	this->listeners.store(*other.listeners.read());
 	this->closeListeners = std::move(other.closeListeners);
+	this->executor_ptr = other.executor_ptr;
+	this->assign_options(other.opts);
+	this->stopper = other.stopper;
+
+	if(this->closed.load())
+		this->completed->complete();
+
 	return *this;
 }
 
 TPL
 self& self::addListener(self_t::listener_type listener){
-	LOCK
-	this->listeners.push_back(listener);
+	self_t::listener_entry entry;
+	entry.value = std::move(listener);
+	return this->addEntry(std::move(entry));
+}
+
+TPL
+self_t::stream_type& self::onShared(self_t::shared_listener_type listener){
+	self_t::listener_entry entry;
+	entry.shared = std::move(listener);
+	return this->addEntry(std::move(entry));
+}
+
+TPL
+self_t::stream_type& self::onBatch(self_t::batch_listener_type listener){
+	self_t::listener_entry entry;
+	entry.span = std::move(listener);
+	return this->addEntry(std::move(entry));
+}
+
+TPL
+self_t::stream_type& self::addEntry(self_t::listener_entry entry){
+	this->subscribeEntry(std::move(entry));
 	return *this;
 }
 
+TPL
+self_t::subscription_type self::subscribeEntry(self_t::listener_entry entry){
+	const auto id = this->nextSubscription++;
+	entry.id = id;
+
+	std::shared_ptr<const registered_listener> listener{new registered_listener(std::move(entry))};
+	this->listeners.update([&](listener_storage_type& listeners){
+		listeners.push_back(listener);
+	});
+
+	return id;
+}
+
+TPL
+self_t::subscription_type self::subscribe(self_t::listener_type listener){
+	self_t::listener_entry entry;
+	entry.value = std::move(listener);
+	return this->subscribeEntry(std::move(entry));
+}
+
+TPL
+self_t::subscription_type self::subscribeShared(self_t::shared_listener_type listener){
+	self_t::listener_entry entry;
+	entry.shared = std::move(listener);
+	return this->subscribeEntry(std::move(entry));
+}
+
+TPL
+self_t::subscription_type self::subscribeBatch(self_t::batch_listener_type listener){
+	self_t::listener_entry entry;
+	entry.span = std::move(listener);
+	return this->subscribeEntry(std::move(entry));
+}
+
+TPL
+bool self::removeListener(self_t::subscription_type subscription){
+	bool removed = false;
+
+	this->listeners.update([&](listener_storage_type& listeners){
+		const auto it = std::find_if(listeners.begin(), listeners.end(), [&](const std::shared_ptr<const registered_listener>& listener){
+			return listener->entry.id == subscription;
+		});
+
+		if(it == listeners.end())
+			return;
+
+		//deliveries holding an older snapshot skip it from now on
+		(*it)->active.store(false);
+		listeners.erase(it);
+		removed = true;
+	});
+
+	return removed;
+}
+
+TPL
+void self::dispatch(const self_t::listener_entry& entry, const self_t::envelope& item){
+	if(item.batch){
+		const auto& values = *item.batch;
+
+		if(entry.batch)
+			entry.batch(item.batch);
+		else if(entry.span)
+			entry.span(values.view());
+		else if(entry.value){
+			for(const auto& value : values)
+				entry.value(value);
+		}else if(entry.shared){
+			for(const auto& value : values)
+				entry.shared(self_t::shared_value{item.batch, &value});
+		}
+
+		return;
+	}
+
+	if(entry.value)
+		entry.value(*item.value);
+	else if(entry.shared)
+		entry.shared(item.value);
+	else if(entry.span)
+		entry.span(self_t::span_type{item.value.get(), 1});
+}
+
 TPL
 self_t::stream_type& self::onValue(self_t::listener_type listener){
-	return this->addListener(listener);
+	return this->addListener(std::move(listener));
 }
 
 TPL
-self_t::stream_type& self::emit(const self_t::value_type& value){
+void self::enqueue(self_t::envelope& value){
+	struct emitting_guard{
+		std::atomic<std::size_t>& count;
+		~emitting_guard(){ --this->count; }
+	};
+
+	++this->emitting;
+	emitting_guard guard{this->emitting};
 	IF_CLOSED_THROW
 
-	std::async(std::launch::async, [=]{
-		LOCK
-		for(const auto& listener : this->listeners)
-			listener(value);
-	});
+	#ifdef ASYNC_STREAM_METRICS
+	value.enqueued = async::metrics::now();
+	this->stats->emitted.add(value.batch ? value.batch->size() : 1);
+	#endif
+
+	#ifdef ASYNC_TRACE
+	async::trace::record(async::trace::event_kind::emit, this, value.batch ? value.batch->size() : 1);
+	#endif
+
+	if(this->queue->try_push(value))
+		return this->schedule();
+
+	switch(this->opts.overflow){
+		case async::overflow_policy::drop_newest:
+			++this->droppedCount;
+			return;
+
+		case async::overflow_policy::drop_oldest:
+			do{
+				if(this->queue->evict())
+					++this->droppedCount;
+			}while(!this->queue->try_push(value));
+			return this->schedule();
+
+		case async::overflow_policy::fail:
+			throw self_t::exception(self::ERR_STREAM_FULL);
+
+		case async::overflow_policy::block:
+		default:
+			break;
+	}
+
+	#ifdef ASYNC_STREAM_METRICS
+	this->stats->blocked.add();
+	#endif
+
+	this->schedule();
+	while(!this->queue->try_push(value)){
+		//A cancelled producer must not wait for listeners that may never catch up
+		if(this->stopRequested()){
+			++this->droppedCount;
+			return;
+		}
+
+		//A worker must not wait for a job queued behind it (be it a delivery of this stream or a task of the pool it works for),
+		//but running that job here could re-enter a delivery further down this thread's stack: another thread runs it instead
+		async::details::compensate_current_thread();
+
+		std::unique_lock<mutex_type> lock{this->stateMutex};
+		++this->blockedProducers;
+		this->stateCv.wait_for(lock, std::chrono::milliseconds{10}, [this]{
+			return this->queue->size() < this->queue->capacity() || this->stopRequested();
+		});
+		--this->blockedProducers;
+	}
+
+	this->schedule();
+}
+
+TPL
+void self::notify_producers(){
+	if(this->blockedProducers.load() == 0)
+		return;
+
+	{
+		STATE_LOCK
+	}
+
+	this->stateCv.notify_all();
+}
+
+TPL
+void self::schedule(){
+	//Pairs with the fence in drain: either the delivery sees the new value or we see it has parked
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(this->drainers.load(std::memory_order_relaxed) >= this->maxDrainers)
+		return;
+
+	if(this->acquire_drainer())
+		this->executor_ptr->execute([this]{ this->drain(); });
+}
+
+TPL
+bool self::acquire_drainer(){
+	auto count = this->drainers.load();
+	while(count < this->maxDrainers){
+		if(this->drainers.compare_exchange_weak(count, count + 1))
+			return true;
+	}
+
+	return false;
+}
 
+TPL
+bool self::deliver(){
+	using storage_type = typename std::aligned_storage<sizeof(envelope), alignof(envelope)>::type;
+
+	storage_type storage;
+	auto* value = reinterpret_cast<envelope*>(&storage);
+	bool delivered = false;
+
+	const auto listeners = this->listeners.read();
+
+	#ifdef ASYNC_STREAM_METRICS
+	const auto depth = this->queue->size();
+	auto maxDepth = this->stats->maxDepth.load(std::memory_order_relaxed);
+	while(depth > maxDepth && !this->stats->maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed));
+	#endif
+
+	for(std::size_t i = 0 ; i < self::DELIVERY_BURST && this->queue->try_pop(value) ; ++i){
+		delivered = true;
+		this->notify_producers();
+
+		#ifdef ASYNC_STREAM_METRICS
+		//The end of a listener is the start of the next one: a single clock read per listener
+		auto clock = async::metrics::now();
+		this->stats->dispatch.record(clock - value->enqueued);
+		this->stats->delivered.add(value->batch ? value->batch->size() : 1);
+		#endif
+
+		for(const auto& listener : *listeners){
+			if(!listener->active.load(std::memory_order_acquire))
+				continue;
+
+			#ifdef ASYNC_TRACE
+			async::trace::record(async::trace::event_kind::listener_enter, this, listener->entry.id);
+			#endif
+
+			try{
+				self::dispatch(listener->entry, *value);
+			}catch(...){
+				//a failing listener must not prevent the others from receiving the value
+			}
+
+			#ifdef ASYNC_TRACE
+			async::trace::record(async::trace::event_kind::listener_exit, this, listener->entry.id);
+			#endif
+
+			#ifdef ASYNC_STREAM_METRICS
+			const auto end = async::metrics::now();
+			listener->duration.record(end - clock);
+			clock = end;
+			#endif
+		}
+
+		value->~envelope();
+	}
+
+	return delivered;
+}
+
+TPL
+bool self::idle_wait() const{
+	for(std::size_t i = 0 ; i < this->opts.spin ; ++i){
+		if(this->queue->size() != 0 || this->closed.load(std::memory_order_relaxed))
+			return true;
+
+		async::details::cpu_relax();
+	}
+
+	return false;
+}
+
+TPL
+void self::drain(){
+	for(;;){
+		while(this->deliver());
+
+		if(this->closed.load()){
+			if(this->emitting.load() != 0){
+				std::this_thread::yield();
+				continue;
+			}
+
+			if(this->queue->size() != 0)
+				continue;
+
+			//The last delivery to leave runs the close listeners, once every other one is done delivering
+			if(this->drainers.fetch_sub(1) != 1 || this->completing.exchange(true))
+				return;
+
+			{
+				LOCK
+				this->closeNotified = true;
+				for(const auto& f : this->closeListeners)
+					(*f)();
+			}
+
+			#ifdef ASYNC_TRACE
+			async::trace::record(async::trace::event_kind::complete, this);
+			#endif
+
+			//Once completed, the stream may be destroyed by a waiting thread: it must not be touched afterwards
+			const auto completed = this->completed;
+			completed->complete();
+			return;
+		}
+
+		if(this->idle_wait())
+			continue;
+
+		this->drainers.fetch_sub(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		//A close that saw this delivery still running did not schedule another one: the close listeners are left to this one
+		if((this->queue->size() == 0 && !this->closed.load()) || !this->acquire_drainer())
+			return;
+	}
+}
+
+namespace async{
+	namespace details{
+		template <class T, class... Args>
+		std::shared_ptr<T> make_value(std::true_type /*constructible*/, Args&&... args){
+			return std::make_shared<T>(std::forward<Args>(args)...);
+		}
+
+		template <class T, class... Args>
+		std::shared_ptr<T> make_value(std::false_type /*constructible*/, Args&&... args){
+			return std::make_shared<T>(T{std::forward<Args>(args)...});
+		}
+
+		template <class T, class... Args>
+		std::shared_ptr<T> allocate_value(const async::shared_resource& resource, std::true_type /*constructible*/, Args&&... args){
+			return std::allocate_shared<T>(async::resource_allocator<T>{resource}, std::forward<Args>(args)...);
+		}
+
+		template <class T, class... Args>
+		std::shared_ptr<T> allocate_value(const async::shared_resource& resource, std::false_type /*constructible*/, Args&&... args){
+			return std::allocate_shared<T>(async::resource_allocator<T>{resource}, T{std::forward<Args>(args)...});
+		}
+	}
+}
+
+TPL
+template <class... Args>
+self_t::shared_value self::make_value(Args&&... args){
+	return async::details::make_value<self_t::value_type>(
+		std::is_constructible<self_t::value_type, Args&&...>{},
+		std::forward<Args>(args)...
+	);
+}
+
+TPL
+template <class... Args>
+self_t::shared_value self::allocate_value(Args&&... args) const{
+	if(!this->opts.resource)
+		return self::make_value(std::forward<Args>(args)...);
+
+	return async::details::allocate_value<self_t::value_type>(
+		this->opts.resource,
+		std::is_constructible<self_t::value_type, Args&&...>{},
+		std::forward<Args>(args)...
+	);
+}
+
+TPL
+template <class... Args>
+self_t::shared_batch self::allocate_batch(Args&&... args) const{
+	if(!this->opts.resource)
+		return std::make_shared<const self_t::batch_type>(std::forward<Args>(args)...);
+
+	return std::allocate_shared<self_t::batch_type>(async::resource_allocator<self_t::batch_type>{this->opts.resource}, std::forward<Args>(args)...);
+}
+
+TPL
+self_t::stream_type& self::emitShared(self_t::shared_value value){
+	self_t::envelope item;
+	item.value = std::move(value);
+	this->enqueue(item);
 	return *this;
 }
 
+TPL
+self_t::stream_type& self::emitShared(self_t::shared_batch values){
+	if(values->empty())
+		return *this;
+
+	self_t::envelope item;
+	item.batch = std::move(values);
+	this->enqueue(item);
+	return *this;
+}
+
+TPL
+template <class Range>
+self_t::stream_type& self::emitBatch(const Range& values){
+	using std::begin;
+	using std::end;
+	return this->emitBatch(begin(values), end(values));
+}
+
+TPL
+self_t::stream_type& self::emitBatch(std::vector<self_t::value_type>&& values){
+	return this->emitShared(this->allocate_batch(std::move(values)));
+}
+
+TPL
+template <class Iterator>
+self_t::stream_type& self::emitBatch(Iterator first, Iterator last){
+	return this->emitShared(this->allocate_batch(first, last));
+}
+
+TPL
+self_t::stream_type& self::emit(const self_t::value_type& value){
+	return this->emitShared(this->allocate_value(value));
+}
+
+TPL
+self_t::stream_type& self::emit(self_t::value_type&& value){
+	return this->emitShared(this->allocate_value(std::move(value)));
+}
+
 TPL
 self_t::stream_type& self::operator<<(const self_t::value_type& value){
 	return this->emit(value);
 }
 
+TPL
+self_t::stream_type& self::operator<<(self_t::value_type&& value){
+	return this->emit(std::move(value));
+}
+
 TPL
 template <class... Args>
 self_t::stream_type& self::emit(Args&&... args){
-	IF_CLOSED_THROW
-
-	std::async(std::launch::async, [=]{
-		LOCK
-		self_t::value_type value{args...};
-		for(const auto& listener : this->listeners)
-			listener(value);
-	});
-
-	return *this;
+	return this->emitShared(this->allocate_value(std::forward<Args>(args)...));
 }
 
 TPL
 self_t::stream_type& self::onClose(self_t::close_listener_type listener){
-	LOCK
-	this->closeListeners.push_back(listener);
+	{
+		LOCK
+		if(!this->closeNotified){
+			this->closeListeners.push_back(std::make_shared<close_listener_type>(std::move(listener)));
+			return *this;
+		}
+	}
+
+	listener();
 	return *this;
 }
 
 TPL
 self_t::stream_type& self::close(){
-	if(!this->closed.load()){
-		this->closed.store(true);
-		std::async(std::launch::async, [=]{
-			LOCK
-			for(auto f : this->closeListeners)
-				f();
-		});
-	}
+	if(this->closed.exchange(true))
+		return *this;
 
+	#ifdef ASYNC_TRACE
+	async::trace::record(async::trace::event_kind::close, this);
+	#endif
+
+	this->schedule();
 	return *this;
 }
 
 TPL
 void self::wait() const{
-	if(this->closed.load())
-		return;
+	this->completed->wait();
+}
 
-	std::condition_variable cv;
-	this->onClose([&]{ cv.notify_one(); });
-	std::unique_lock<std::mutex> lock{this->mutex};
-	cv.wait(lock, [&]{ return this->closed.load(); });
+TPL
+std::size_t self::depth() const{
+	return this->queue->size();
+}
+
+TPL
+std::size_t self::capacity() const{
+	return this->queue->capacity();
 }
 
 TPL
 self_t::stream_type& self::pipe(stream_type* stream){
-	return this->onValue([=](const value_type& value){
-		stream->emit(value);
-	});
+	self_t::listener_entry entry;
+	entry.shared = [=](const shared_value& value){ stream->emitShared(value); };
+	entry.batch = [=](const shared_batch& values){ stream->emitShared(values); };
+	return this->addEntry(std::move(entry));
 }
 
 TPL
 template <class Predicate>
 self_t::shared_stream self::filter(Predicate predicate){
-	shared_stream filtered{new stream_type()};
+	shared_stream filtered = this->derive();
 
-	this->onValue([=](const value_type& value){
-		if(predicate(value))
-			filtered->emit(value);
-	});
+	self_t::listener_entry entry;
+
+	entry.shared = [=](const shared_value& value){
+		if(predicate(*value))
+			filtered->emitShared(value);
+	};
+
+	entry.batch = [=](const shared_batch& values){
+		std::vector<value_type> kept;
+		auto it = values->begin();
+
+		//As long as every value passes, the batch can be forwarded as is
+		for(; it != values->end() && predicate(*it) ; ++it);
+
+		if(it == values->end()){
+			filtered->emitShared(values);
+			return;
+		}
+
+		kept.reserve(values->size() - 1);
+		for(auto passed = values->begin() ; passed != it ; ++passed)
+			kept.push_back(*passed);
+
+		for(++it ; it != values->end() ; ++it){
+			if(predicate(*it))
+				kept.push_back(*it);
+		}
+
+		if(!kept.empty())
+			filtered->emitBatch(std::move(kept));
+	};
+
+	this->addEntry(std::move(entry));
 
 	this->onClose([=]{
 		filtered->close();
@@ -158,13 +700,23 @@ self_t::shared_stream self::filter(Predicate predicate){
 TPL
 template <class U, class Mapper>
 std::shared_ptr<async::stream<U>> self::map(Mapper mapper){
-	std::shared_ptr<async::stream<U>> mapped{new async::stream<U>{}};
+	auto mapped = this->template derive<U>();
 
-	this->onValue([=](const value_type& value){
+	self_t::listener_entry entry;
+
+	entry.value = [=](const value_type& value){
 		mapped->emit(
 			mapper(value)
 		);
-	});
+	};
+
+	entry.batch = [=](const shared_batch& values){
+		mapped->emitShared(mapped->allocate_batch(
+			values->begin(), values->end(), mapper
+		));
+	};
+
+	this->addEntry(std::move(entry));
 
 	this->onClose([=]{
 		mapped->close();
@@ -179,53 +731,546 @@ std::shared_ptr<async::stream<U>> self::mapTo(Mapper mapper){
 	return this->map<U>(mapper);
 }
 
+TPL
+template <class U, class Parser>
+std::shared_ptr<async::stream<U>> self::filterMap(Parser parser){
+	auto mapped = this->template derive<U>();
+
+	self_t::listener_entry entry;
+
+	entry.value = [=](const value_type& value){
+		U result;
+		if(parser(value, result))
+			mapped->emit(std::move(result));
+	};
+
+	entry.batch = [=](const shared_batch& values){
+		std::vector<U> kept;
+		kept.reserve(values->size());
+
+		for(const auto& value : *values){
+			U result;
+			if(parser(value, result))
+				kept.push_back(std::move(result));
+		}
+
+		if(!kept.empty())
+			mapped->emitBatch(std::move(kept));
+	};
+
+	this->addEntry(std::move(entry));
+
+	this->onClose([=]{
+		mapped->close();
+	});
+
+	return mapped;
+}
+
+TPL
+template <class U, class Mapper>
+std::shared_ptr<async::stream<U>> self::parallelMap(Mapper mapper, std::size_t concurrency, bool ordered){
+	using state_type = async::details::parallel_map_state<value_type, U, Mapper>;
+
+	auto mapped = this->template derive<U>();
+	std::shared_ptr<state_type> state{new state_type(
+		std::move(mapper),
+		mapped,
+		this->executor_ptr,
+		concurrency == 0 ? this->executor_ptr->concurrency() : concurrency,
+		ordered
+	)};
+
+	self_t::listener_entry entry;
+
+	entry.shared = [state](const shared_value& value){
+		state->push(value);
+	};
+
+	entry.batch = [state](const shared_batch& values){
+		for(const auto& value : *values)
+			state->push(shared_value{values, &value});
+	};
+
+	this->addEntry(std::move(entry));
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	return mapped;
+}
+
+TPL
+self_t::shared_window_stream self::window(std::size_t size, std::size_t step){
+	using state_type = async::details::count_window_state<value_type>;
+
+	if(size == 0)
+		throw self_t::exception(self::ERR_EMPTY_WINDOW);
+
+	auto windowed = this->template derive<window_type>();
+	std::shared_ptr<state_type> state{new state_type(size, step == 0 ? size : step, windowed)};
+
+	this->onBatch([state](span_type values){
+		state->push(values.begin(), values.end());
+	});
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	return windowed;
+}
+
+TPL
+self_t::shared_window_stream self::window(self_t::duration size, self_t::duration step){
+	using state_type = async::details::time_window_state<value_type>;
+
+	if(size <= duration::zero())
+		throw self_t::exception(self::ERR_EMPTY_WINDOW);
+
+	auto windowed = this->template derive<window_type>();
+	std::shared_ptr<state_type> state{new state_type(
+		size,
+		step <= duration::zero() ? size : step,
+		windowed,
+		this->timer()
+	)};
+
+	this->onBatch([state](span_type values){
+		state->push(values.begin(), values.end());
+	});
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	state->start(state, this->executor_ptr);
+	return windowed;
+}
+
+TPL
+template <class Reducer, class Accumulator>
+std::shared_ptr<async::stream<Accumulator>> self::windowReduce(std::size_t size, Reducer reducer, Accumulator identity){
+	using state_type = async::details::fold_window_state<value_type, Accumulator, Reducer>;
+
+	if(size == 0)
+		throw self_t::exception(self::ERR_EMPTY_WINDOW);
+
+	auto aggregated = this->template derive<Accumulator>();
+	std::shared_ptr<state_type> state{new state_type(std::move(reducer), std::move(identity), size, aggregated)};
+
+	this->onBatch([state](span_type values){
+		state->push(values.begin(), values.end());
+	});
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	return aggregated;
+}
+
+TPL
+template <class Reducer, class Accumulator>
+std::shared_ptr<async::stream<Accumulator>> self::windowReduce(self_t::duration size, Reducer reducer, Accumulator identity){
+	using state_type = async::details::fold_window_state<value_type, Accumulator, Reducer>;
+
+	if(size <= duration::zero())
+		throw self_t::exception(self::ERR_EMPTY_WINDOW);
+
+	auto aggregated = this->template derive<Accumulator>();
+	std::shared_ptr<state_type> state{new state_type(std::move(reducer), std::move(identity), 0, aggregated)};
+
+	this->onBatch([state](span_type values){
+		state->push(values.begin(), values.end());
+	});
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	state->start(state, this->timer(), this->executor_ptr, size);
+	return aggregated;
+}
+
+TPL
+self_t::shared_stream self::throttle(self_t::duration interval){
+	if(interval <= duration::zero())
+		throw self_t::exception(self::ERR_NON_POSITIVE_DURATION);
+
+	shared_stream throttled = this->derive();
+	std::shared_ptr<async::details::throttle_state> state{new async::details::throttle_state(interval)};
+
+	self_t::listener_entry entry;
+
+	entry.shared = [=](const shared_value& value){
+		if(state->admit())
+			throttled->emitShared(value);
+	};
+
+	entry.batch = [=](const shared_batch& values){
+		for(const auto& value : *values){
+			if(state->admit())
+				throttled->emitShared(shared_value{values, &value});
+		}
+	};
+
+	this->addEntry(std::move(entry));
+
+	this->onClose([=]{
+		throttled->close();
+	});
+
+	return throttled;
+}
+
+TPL
+self_t::shared_stream self::debounce(self_t::duration quiet){
+	using state_type = async::details::debounce_state<value_type>;
+
+	if(quiet <= duration::zero())
+		throw self_t::exception(self::ERR_NON_POSITIVE_DURATION);
+
+	shared_stream debounced = this->derive();
+	std::shared_ptr<state_type> state{new state_type(quiet, debounced, this->timer(), this->executor_ptr)};
+
+	self_t::listener_entry entry;
+
+	entry.shared = [state](const shared_value& value){
+		state->push(value);
+	};
+
+	entry.batch = [state](const shared_batch& values){
+		state->push(shared_value{values, &(*values)[values->size() - 1]});
+	};
+
+	this->addEntry(std::move(entry));
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	return debounced;
+}
+
+TPL
+self_t::shared_stream self::sample(self_t::duration period){
+	using state_type = async::details::sample_state<value_type>;
+
+	if(period <= duration::zero())
+		throw self_t::exception(self::ERR_NON_POSITIVE_DURATION);
+
+	shared_stream sampled = this->derive();
+	std::shared_ptr<state_type> state{new state_type(sampled, this->timer())};
+
+	self_t::listener_entry entry;
+
+	entry.shared = [state](const shared_value& value){
+		state->push(value);
+	};
+
+	entry.batch = [state](const shared_batch& values){
+		state->push(shared_value{values, &(*values)[values->size() - 1]});
+	};
+
+	this->addEntry(std::move(entry));
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	state->start(this->executor_ptr, period);
+	return sampled;
+}
+
+TPL
+self_t::shared_stream self::timeout(self_t::duration limit, std::function<void()> onTimeout){
+	using state_type = async::details::timeout_state<value_type>;
+
+	if(limit <= duration::zero())
+		throw self_t::exception(self::ERR_NON_POSITIVE_DURATION);
+
+	shared_stream guarded = this->derive();
+	std::shared_ptr<state_type> state{new state_type(limit, guarded, this->timer(), this->executor_ptr, std::move(onTimeout))};
+
+	self_t::listener_entry entry;
+
+	entry.shared = [state](const shared_value& value){
+		state->push(value);
+	};
+
+	entry.batch = [state](const shared_batch& values){
+		state->push(values);
+	};
+
+	this->addEntry(std::move(entry));
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	state->start();
+	return guarded;
+}
+
+TPL
+self_t::shared_stream self::delay(self_t::duration lag){
+	using state_type = async::details::delay_state<value_type>;
+
+	if(lag <= duration::zero())
+		throw self_t::exception(self::ERR_NON_POSITIVE_DURATION);
+
+	shared_stream delayed = this->derive();
+	std::shared_ptr<state_type> state{new state_type(lag, delayed, this->timer(), this->executor_ptr)};
+
+	self_t::listener_entry entry;
+
+	entry.shared = [state](const shared_value& value){
+		state->push(value, nullptr);
+	};
+
+	entry.batch = [state](const shared_batch& values){
+		state->push(nullptr, values);
+	};
+
+	this->addEntry(std::move(entry));
+
+	this->onClose([state]{
+		state->close();
+	});
+
+	return delayed;
+}
+
 TPL
 self_t::stream_type& self::peek(self_t::listener_type listener){
-	return this->onValue(listener);
+	return this->onValue(std::move(listener));
 }
 
 TPL
 void self::forEach(self_t::listener_type listener){
-	this->peek(listener);
+	this->peek(std::move(listener));
+}
+
+TPL
+async::pipeline<T, T, async::fused::identity> self::fuse(){
+	return async::pipeline<T, T, async::fused::identity>{this, async::fused::identity{}};
 }
 
 TPL
 template <class Reducer, class Accumulator>
 Accumulator self::reduce(Reducer reducer, Accumulator start){
 	Accumulator acc = start;
+	mutex_type accMutex;
 	this->onValue([&](const value_type& value){
+		lock_guard _{accMutex}; //values may be delivered concurrently
 		acc = reducer(acc, value);
 	});
 	this->wait();
 	return acc;
 }
 
+TPL
+template <class Reducer, class Combiner, class Accumulator>
+Accumulator self::reduce(Reducer reducer, Combiner combiner, Accumulator identity){
+	//An ordered stream has a single delivery at a time, its values all go to the same accumulator to keep their order
+	const auto slotCount = this->maxDrainers > 1 ? std::max(this->maxDrainers, this->executor_ptr->concurrency()) : 1;
+	async::details::reduce_slots<Accumulator> slots{slotCount, identity};
+
+	self_t::listener_entry entry;
+
+	entry.value = [&](const value_type& value){
+		slots.fold([&](Accumulator& acc){
+			acc = reducer(std::move(acc), value);
+		});
+	};
+
+	entry.span = [&](span_type values){
+		slots.fold([&](Accumulator& acc){
+			for(const auto& value : values)
+				acc = reducer(std::move(acc), value);
+		});
+	};
+
+	this->addEntry(std::move(entry));
+	this->wait();
+	return slots.combine(combiner);
+}
+
+TPL
+template <class Container>
+Container self::collect(){
+	const auto slotCount = this->maxDrainers > 1 ? std::max(this->maxDrainers, this->executor_ptr->concurrency()) : 1;
+	async::details::reduce_slots<Container> slots{slotCount, Container{}};
+
+	self_t::listener_entry entry;
+
+	entry.value = [&](const value_type& value){
+		slots.fold([&](Container& values){
+			values.insert(values.end(), value);
+		});
+	};
+
+	entry.span = [&](span_type batch){
+		slots.fold([&](Container& values){
+			for(const auto& value : batch)
+				values.insert(values.end(), value);
+		});
+	};
+
+	this->addEntry(std::move(entry));
+	this->wait();
+
+	return slots.combine([](Container lhs, Container rhs){
+		for(auto& value : rhs)
+			lhs.insert(lhs.end(), std::move(value));
+
+		return lhs;
+	});
+}
+
 TPL
 template <class Predicate>
-bool self::anyMatch(Predicate predicate){
-	return this->reduce([&](bool acc, const value_type& value){
-		return acc || predicate(value);
-	}, false);
+bool self::anyMatch(Predicate predicate, bool stopUpstream){
+	struct match_state{
+		std::atomic_bool resolved{false};
+		std::atomic<subscription_type> subscription{0};
+		bool result = false;
+		bool done = false;
+		mutex_type mutex{};
+		std::condition_variable cv{};
+
+		bool resolve(bool value){
+			if(this->resolved.exchange(true))
+				return false;
+
+			std::lock_guard<mutex_type> _{this->mutex};
+			this->result = value;
+			this->done = true;
+			return true;
+		}
+	};
+
+	auto state = std::make_shared<match_state>();
+
+	const auto subscription = this->subscribe([this, state, predicate, stopUpstream](const value_type& value){
+		if(state->resolved.load(std::memory_order_relaxed) || !predicate(value) || !state->resolve(true))
+			return;
+
+		//The result is known: stop listening (and producing) before waking up the caller
+		const auto id = state->subscription.load();
+		if(id != 0)
+			this->removeListener(id);
+
+		if(stopUpstream)
+			this->requestStop();
+
+		state->cv.notify_all();
+	});
+
+	state->subscription.store(subscription);
+	if(state->resolved.load())
+		this->removeListener(subscription);
+
+	this->onClose([state]{
+		if(state->resolve(false))
+			state->cv.notify_all();
+	});
+
+	std::unique_lock<mutex_type> lock{state->mutex};
+	state->cv.wait(lock, [&]{ return state->done; });
+	return state->result;
 }
 
 TPL
 template <class Predicate>
-bool self::allMatch(Predicate predicate){
-	return this->reduce([&](bool acc, const value_type& value){
-		return acc && predicate(value);
-	}, true);
+bool self::allMatch(Predicate predicate, bool stopUpstream){
+	return !this->anyMatch([predicate](const value_type& value){
+		return !predicate(value);
+	}, stopUpstream);
 }
 
 TPL
 template <class Predicate>
-bool self::noneMatch(Predicate predicate){
-	return !this->anyMatch(predicate);
+bool self::noneMatch(Predicate predicate, bool stopUpstream){
+	return !this->anyMatch(predicate, stopUpstream);
+}
+
+TPL
+self_t::stream_type& self::requestStop(){
+	this->stopper.request_stop();
+	this->notify_producers();
+	return *this;
 }
 
+TPL
+template <class U>
+std::shared_ptr<async::stream<U>> self::derive() const{
+	//The derived streams of a pipeline come from the same resource as its values
+	auto derived = this->opts.resource
+		? std::allocate_shared<async::stream<U>>(async::resource_allocator<async::stream<U>>{this->opts.resource}, this->opts)
+		: std::make_shared<async::stream<U>>(this->opts);
+
+	derived->stopper = this->stopper;
+
+	#ifdef ASYNC_STREAM_METRICS
+	std::weak_ptr<async::stream<U>> weak = derived;
+	STATE_LOCK
+	this->derivedDumps.push_back([weak](std::ostream& out, const std::string& name){
+		if(const auto stream = weak.lock())
+			stream->dumpMetrics(out, name);
+	});
+	#endif
+
+	return derived;
+}
+
+#ifdef ASYNC_STREAM_METRICS
+TPL
+async::metrics::stream_snapshot self::metrics() const{
+	async::metrics::stream_snapshot snapshot;
+	snapshot.emitted = this->stats->emitted.load();
+	snapshot.delivered = this->stats->delivered.load();
+	snapshot.dropped = this->droppedCount.load();
+	snapshot.blocked = this->stats->blocked.load();
+	snapshot.depth = this->queue->size();
+	snapshot.maxDepth = this->stats->maxDepth.load(std::memory_order_relaxed);
+	snapshot.capacity = this->queue->capacity();
+	snapshot.dispatch = this->stats->dispatch.snapshot();
+
+	for(const auto& listener : *this->listeners.read()){
+		async::metrics::listener_snapshot entry;
+		entry.id = listener->entry.id;
+		entry.duration = listener->duration.snapshot();
+		entry.invocations = entry.duration.count;
+		snapshot.listeners.push_back(std::move(entry));
+	}
+
+	return snapshot;
+}
+
+TPL
+std::ostream& self::dumpMetrics(std::ostream& out, const std::string& name) const{
+	out << name << ": " << this->metrics();
+
+	std::vector<self_t::metrics_dump_type> dumps;
+	{
+		STATE_LOCK
+		dumps = this->derivedDumps;
+	}
+
+	for(std::size_t i = 0 ; i < dumps.size() ; ++i)
+		dumps[i](out, name + "." + std::to_string(i));
+
+	return out;
+}
+#endif
 
 #undef TPL
 #undef constructor
 #undef self
 #undef self_t
 #undef LOCK
+#undef STATE_LOCK
 #undef IF_CLOSED_THROW
@@ -0,0 +1,126 @@
+#pragma once
+#include <async/executor/fwd.h>
+#include <async/memory/fwd.h>
+#include <async/timer/fwd.h>
+#include <cstddef>
+#include <utility>
+
+namespace async{
+	/**
+	 * What a stream does when a value is emitted while its delivery queue is full
+	 */
+	enum class overflow_policy{
+		block, ///< The producer waits until there is room for the value
+		drop_newest, ///< The emitted value is discarded
+		drop_oldest, ///< The oldest value awaiting delivery is discarded to make room
+		fail ///< An exception is thrown to the producer
+	};
+
+	/**
+	 * The kind of queue a stream buffers its values in
+	 */
+	enum class queue_mode{
+		locked, ///< A mutex protected queue, any amount of producers (the default)
+		spsc, ///< A lock-free ring buffer for a single producer thread (the stream is fed by one thread at a time)
+		mpmc ///< A lock-free ring buffer for any amount of producers, values may be delivered by several workers at once
+	};
+
+	/**
+	 * The settings used to construct a stream (propagated to the streams derived from it)
+	 */
+	struct stream_options{
+		static constexpr std::size_t DEFAULT_CAPACITY = 1024; ///< @property DEFAULT_CAPACITY being the default capacity of the delivery queue
+		static constexpr std::size_t UNBOUNDED = 0; ///< @property UNBOUNDED being the capacity used for queues without limits (async::queue_mode::locked only)
+		static constexpr std::size_t DEFAULT_SPIN = 256; ///< @property DEFAULT_SPIN being the default amount of polls before an idle delivery parks
+
+		shared_executor executor = nullptr; ///< @property executor being the executor used to deliver values (nullptr means async::default_executor)
+		std::size_t capacity = DEFAULT_CAPACITY; ///< @property capacity being the maximum amount of values awaiting delivery
+		overflow_policy overflow = overflow_policy::block; ///< @property overflow being what to do when the delivery queue is full
+		queue_mode mode = queue_mode::locked; ///< @property mode being the kind of queue used to buffer values
+		std::size_t spin = DEFAULT_SPIN; ///< @property spin being the amount of times an empty queue is polled before the delivery parks
+		std::size_t concurrency = 1; ///< @property concurrency being the maximum amount of deliveries running at once (async::queue_mode::mpmc only)
+		shared_resource resource = nullptr; ///< @property resource being where the values, the queue and the derived streams are allocated (nullptr means the global heap)
+		shared_timer timer = nullptr; ///< @property timer being the timer used by the time-based operators (nullptr means async::default_timer)
+
+		/**
+		 * Use the given executor to deliver values
+		 * @param value being the executor to use
+		 * @return a reference to these options
+		 */
+		stream_options& withExecutor(shared_executor value){
+			this->executor = std::move(value);
+			return *this;
+		}
+
+		/**
+		 * Bound the delivery queue to the given capacity
+		 * @param value being the capacity (async::stream_options::UNBOUNDED for no limit)
+		 * @return a reference to these options
+		 */
+		stream_options& withCapacity(std::size_t value){
+			this->capacity = value;
+			return *this;
+		}
+
+		/**
+		 * Select what to do when the delivery queue is full
+		 * @param value being the policy to use
+		 * @return a reference to these options
+		 */
+		stream_options& withOverflow(overflow_policy value){
+			this->overflow = value;
+			return *this;
+		}
+
+		/**
+		 * Select the kind of queue used to buffer values
+		 * @param value being the queue mode to use
+		 * @return a reference to these options
+		 */
+		stream_options& withMode(queue_mode value){
+			this->mode = value;
+			return *this;
+		}
+
+		/**
+		 * Select how long an idle delivery spins before parking
+		 * @param value being the amount of polls of the empty queue (0 parks right away)
+		 * @return a reference to these options
+		 */
+		stream_options& withSpin(std::size_t value){
+			this->spin = value;
+			return *this;
+		}
+
+		/**
+		 * Allow several deliveries to run at once, listeners are then invoked concurrently and values may be delivered out of order
+		 * @param value being the maximum amount of concurrent deliveries (only honored by async::queue_mode::mpmc)
+		 * @return a reference to these options
+		 */
+		stream_options& withConcurrency(std::size_t value){
+			this->concurrency = value;
+			return *this;
+		}
+
+		/**
+		 * Allocate the values, the queue nodes and the derived streams from the given resource (eg. an async::pool_resource
+		 * shared by a whole pipeline) instead of the global heap
+		 * @param value being the resource to use (kept alive by the stream and by what it allocated)
+		 * @return a reference to these options
+		 */
+		stream_options& withResource(shared_resource value){
+			this->resource = std::move(value);
+			return *this;
+		}
+
+		/**
+		 * Use the given timer for the time-based operators (eg. async::stream<T>::window)
+		 * @param value being the timer to use
+		 * @return a reference to these options
+		 */
+		stream_options& withTimer(shared_timer value){
+			this->timer = std::move(value);
+			return *this;
+		}
+	};
+}
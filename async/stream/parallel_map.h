@@ -0,0 +1,209 @@
+#pragma once
+#include <async/stream/fwd.h>
+#include <async/executor/fwd.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <utility>
+#include <chrono>
+
+namespace async{
+	namespace details{
+		/**
+		 * The state shared by the listener, the workers and the close listener of async::stream<T>::parallelMap
+		 * @tparam T - The type of the values to map
+		 * @tparam U - The type of the mapped values
+		 * @tparam Mapper - Mapper :: (const T&) -> U
+		 */
+		template <class T, class U, class Mapper>
+		class parallel_map_state : public std::enable_shared_from_this<parallel_map_state<T, U, Mapper>>{
+			public:
+				using input_type = std::shared_ptr<const T>;///< @typedef input_type being the type of values to map
+				using output_stream = std::shared_ptr<async::stream<U>>;///< @typedef output_stream being the type of stream the mapped values go to
+				using mutex_type = std::mutex;///< @typedef mutex_type being the type of mutex used to lock the state
+				using lock_type = std::unique_lock<mutex_type>;///< @typedef lock_type being the type of lock used to lock the state
+
+			protected:
+				Mapper mapper;///< @property mapper being the function used to map each value
+				output_stream mapped;///< @property mapped being the stream the mapped values go to
+				shared_executor executor;///< @property executor being the executor the mapper is run on
+				const std::size_t concurrency;///< @property concurrency being the maximum amount of values mapped at once
+				const std::size_t window;///< @property window being the maximum amount of values between their arrival and their emission (bounds the reorder buffer)
+				const bool ordered;///< @property ordered being whether or not the mapped values are emitted in input order
+
+				mutex_type mutex{};///< @property mutex being the mutex used to lock the state
+				std::condition_variable cv{};///< @property cv being the condition variable used to wake up a blocked producer
+				std::deque<std::pair<std::size_t, input_type>> inputs{};///< @property inputs being the values awaiting a worker, along with their sequence number
+				std::map<std::size_t, std::unique_ptr<U>> ready{};///< @property ready being the reorder buffer (nullptr for values the mapper failed on)
+				std::size_t nextInput = 0;///< @property nextInput being the sequence number of the next value to arrive
+				std::size_t nextOutput = 0;///< @property nextOutput being the sequence number of the next value to emit
+				std::size_t pending = 0;///< @property pending being the amount of values arrived but not emitted yet
+				std::size_t workers = 0;///< @property workers being the amount of workers running
+				bool flushing = false;///< @property flushing being whether or not a worker is emitting from the reorder buffer
+				bool closing = false;///< @property closing being whether or not the source stream is done
+
+				/**
+				 * Map the queued values until there are none left
+				 */
+				void work();
+
+				/**
+				 * Emit the values of the reorder buffer that are next in sequence
+				 * @param lock being the lock on the state (released while emitting)
+				 */
+				void flush(lock_type& lock);
+
+				/**
+				 * Account for an emitted (or skipped) value, closing the mapped stream if it was the last one
+				 * @param lock being the lock on the state
+				 */
+				void done(lock_type& lock);
+
+			public:
+				parallel_map_state(Mapper mapper, output_stream mapped, shared_executor executor, std::size_t concurrency, bool ordered);
+
+				/**
+				 * Hand a value to the workers, waits while the window is full
+				 * @param value being the value to map
+				 */
+				void push(input_type value);
+
+				/**
+				 * Close the mapped stream once every value has been emitted
+				 */
+				void close();
+		};
+	}
+}
+
+#define TPL template <class T, class U, class Mapper>
+#define constructor parallel_map_state
+#define self async::details::parallel_map_state<T, U, Mapper>
+#define self_t typename self
+
+TPL
+self::constructor(Mapper mapper, self_t::output_stream mapped, shared_executor executor, std::size_t concurrency, bool ordered)
+: mapper(std::move(mapper)), mapped{std::move(mapped)}, executor{std::move(executor)}, concurrency{concurrency == 0 ? 1 : concurrency}, window{4 * this->concurrency}, ordered{ordered}{
+}
+
+TPL
+void self::push(self_t::input_type value){
+	lock_type lock{this->mutex};
+
+	while(this->pending >= this->window){
+		//A delivery blocked on the executor of the workers must not wait for a job queued behind it (nor run it here, it could
+		//re-enter a delivery further down this thread's stack): another thread runs it instead
+		if(this->executor->owns_current_thread()){
+			lock.unlock();
+			this->executor->compensate();
+			lock.lock();
+		}
+
+		this->cv.wait_for(lock, std::chrono::milliseconds{10});
+	}
+
+	this->inputs.emplace_back(this->nextInput++, std::move(value));
+	++this->pending;
+
+	if(this->workers >= this->concurrency)
+		return;
+
+	++this->workers;
+	lock.unlock();
+
+	auto state = this->shared_from_this();
+	this->executor->execute([state]{
+		state->work();
+	});
+}
+
+TPL
+void self::work(){
+	lock_type lock{this->mutex};
+
+	while(!this->inputs.empty()){
+		auto input = std::move(this->inputs.front());
+		this->inputs.pop_front();
+		lock.unlock();
+
+		std::unique_ptr<U> result;
+		try{
+			result.reset(new U(this->mapper(*input.second)));
+		}catch(...){
+			//a failing mapper skips the value, it must not stall the values behind it
+		}
+
+		if(!this->ordered){
+			if(result){
+				try{
+					this->mapped->emit(std::move(*result));
+				}catch(...){
+				}
+			}
+
+			lock.lock();
+			this->done(lock);
+			continue;
+		}
+
+		lock.lock();
+		this->ready.emplace(input.first, std::move(result));
+		this->flush(lock);
+	}
+
+	--this->workers;
+}
+
+TPL
+void self::flush(self_t::lock_type& lock){
+	//A single worker emits at a time so that the mapped values go out in sequence
+	if(this->flushing)
+		return;
+
+	this->flushing = true;
+
+	for(auto it = this->ready.begin() ; it != this->ready.end() && it->first == this->nextOutput ; it = this->ready.begin()){
+		auto result = std::move(it->second);
+		this->ready.erase(it);
+		++this->nextOutput;
+		lock.unlock();
+
+		if(result){
+			try{
+				this->mapped->emit(std::move(*result));
+			}catch(...){
+			}
+		}
+
+		lock.lock();
+		this->done(lock);
+	}
+
+	this->flushing = false;
+}
+
+TPL
+void self::done(self_t::lock_type&){
+	--this->pending;
+	this->cv.notify_all();
+
+	if(this->closing && this->pending == 0)
+		this->mapped->close();
+}
+
+TPL
+void self::close(){
+	lock_type lock{this->mutex};
+	this->closing = true;
+
+	if(this->pending == 0)
+		this->mapped->close();
+}
+
+#undef TPL
+#undef constructor
+#undef self
+#undef self_t
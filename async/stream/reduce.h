@@ -0,0 +1,93 @@
+#pragma once
+#include <async/queue/decl.h>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+
+namespace async{
+	namespace details{
+		/**
+		 * Retrieve the index of the calling thread, used to pick a slot of async::details::reduce_slots
+		 * @return a number unique to the calling thread (assigned on first use)
+		 */
+		inline std::size_t thread_index(){
+			static std::atomic<std::size_t> next{0};
+			static thread_local const std::size_t index = next++;
+			return index;
+		}
+
+		/**
+		 * Partial accumulators of a reduction, one per thread (modulo the amount of slots), each on its own cache lines
+		 * @tparam Accumulator - The type of the partial results
+		 */
+		template <class Accumulator>
+		class reduce_slots{
+			protected:
+				/**
+				 * A partial accumulator, its flag is only contended when more threads than slots deliver at once
+				 */
+				struct slot{
+					char padding[async::cache_line_size];///< @property padding keeps the slot away from the previous allocation
+					std::atomic_flag busy = ATOMIC_FLAG_INIT;///< @property busy being the flag set while a thread folds values into this slot
+					Accumulator value;///< @property value being the partial result
+					char endPadding[async::cache_line_size];///< @property endPadding keeps the slot away from the next allocation
+
+					explicit slot(const Accumulator& identity) : value(identity){}
+				};
+
+				std::vector<std::unique_ptr<slot>> slots;///< @property slots being the partial accumulators
+
+			public:
+				/**
+				 * Construct the slots of a reduction
+				 * @param count being the amount of slots
+				 * @param identity being the value each slot starts from
+				 */
+				reduce_slots(std::size_t count, const Accumulator& identity){
+					this->slots.reserve(count == 0 ? 1 : count);
+					for(std::size_t i = 0 ; i < (count == 0 ? 1 : count) ; ++i)
+						this->slots.emplace_back(new slot(identity));
+				}
+
+				/**
+				 * Fold values into the slot of the calling thread
+				 * @tparam Folder - Folder :: (Accumulator&) -> void
+				 * @param folder being the function that folds values into the accumulator
+				 */
+				template <class Folder>
+				void fold(Folder folder){
+					auto& target = *this->slots[async::details::thread_index() % this->slots.size()];
+
+					while(target.busy.test_and_set(std::memory_order_acquire))
+						async::details::cpu_relax();
+
+					try{
+						folder(target.value);
+					}catch(...){
+						target.busy.clear(std::memory_order_release);
+						throw;
+					}
+
+					target.busy.clear(std::memory_order_release);
+				}
+
+				/**
+				 * Merge the partial results
+				 * @tparam Combiner - Combiner :: (Accumulator, Accumulator) -> Accumulator
+				 * @param combiner being the function used to merge two partial results
+				 * @return the result of the reduction
+				 * @pre No thread is folding values anymore
+				 */
+				template <class Combiner>
+				Accumulator combine(Combiner combiner){
+					Accumulator result = std::move(this->slots.front()->value);
+					for(std::size_t i = 1 ; i < this->slots.size() ; ++i)
+						result = combiner(std::move(result), std::move(this->slots[i]->value));
+
+					return result;
+				}
+		};
+	}
+}
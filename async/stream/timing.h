@@ -0,0 +1,422 @@
+#pragma once
+#include <async/stream/fwd.h>
+#include <async/stream/window.h>
+#include <async/batch/fwd.h>
+#include <async/executor/fwd.h>
+#include <async/timer/decl.h>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <utility>
+
+namespace async{
+	namespace details{
+		/**
+		 * The state of async::stream<T>::throttle, a value gets through if the previous one did at least an interval ago
+		 */
+		class throttle_state{
+			public:
+				using duration = async::timer::duration;///< @typedef duration being the type of the interval between two values
+
+			protected:
+				const duration interval;///< @property interval being the minimum delay between two values
+				std::atomic<duration::rep> next{0};///< @property next being when the next value may get through (in ticks of async::timer::clock)
+
+			public:
+				explicit throttle_state(duration interval) : interval{interval}{
+				}
+
+				/**
+				 * Determine whether or not a value arriving now gets through (lock-free, values may arrive from several deliveries at once)
+				 * @return TRUE if the value gets through, FALSE if it is dropped
+				 */
+				bool admit(){
+					const auto now = async::timer::now().time_since_epoch().count();
+					auto expected = this->next.load();
+
+					while(now >= expected){
+						if(this->next.compare_exchange_weak(expected, now + this->interval.count()))
+							return true;
+					}
+
+					return false;
+				}
+		};
+
+		/**
+		 * The state of async::stream<T>::debounce, the latest value is emitted once no other value has followed it for a while
+		 * @tparam T - The type of the values
+		 */
+		template <class T>
+		class debounce_state : public std::enable_shared_from_this<debounce_state<T>>{
+			public:
+				using shared_value = std::shared_ptr<const T>;///< @typedef shared_value being the type of values debounced
+				using output_stream = std::shared_ptr<async::stream<T>>;///< @typedef output_stream being the type of stream the values go to
+				using duration = async::timer::duration;///< @typedef duration being the type of the quiet period
+
+			protected:
+				std::mutex mutex{};///< @property mutex being the mutex used to lock the state
+				shared_value latest = nullptr;///< @property latest being the value waiting for the quiet period to elapse (if any)
+				async::timer::time_point last{};///< @property last being when the latest value has arrived
+				const duration quiet;///< @property quiet being how long no value must arrive for the latest one to be emitted
+				bool armed = false;///< @property armed being whether or not a tick has been scheduled
+				bool closed = false;///< @property closed being whether or not the source stream is done
+				output_stream debounced;///< @property debounced being the stream the values go to
+				shared_timer timer;///< @property timer being the timer that measures the quiet period
+				shared_executor executor;///< @property executor being the executor the values are emitted from
+				async::timer::timer_id ticker = 0;///< @property ticker being the handle of the scheduled tick
+
+			public:
+				debounce_state(duration quiet, output_stream debounced, shared_timer timer, shared_executor executor)
+				: quiet{quiet}, debounced{std::move(debounced)}, timer{std::move(timer)}, executor{std::move(executor)}{
+				}
+
+				/**
+				 * Replace the value waiting for the quiet period, the tick is only scheduled once per quiet period (not per value)
+				 * @param value being the value that arrived
+				 */
+				void push(shared_value value){
+					const auto now = async::timer::now();
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(this->closed)
+						return;
+
+					this->latest = std::move(value);
+					this->last = now;
+
+					if(!this->armed){
+						this->armed = true;
+						this->ticker = async::details::tick_after(this->shared_from_this(), this->timer, this->executor, this->quiet);
+					}
+				}
+
+				/**
+				 * Emit the latest value if the quiet period has elapsed since it arrived, wait for the rest of it otherwise
+				 */
+				void tick(){
+					const auto now = async::timer::now();
+					std::lock_guard<std::mutex> _{this->mutex};
+					this->armed = false;
+
+					if(this->closed || !this->latest)
+						return;
+
+					if(now - this->last < this->quiet){
+						this->armed = true;
+						this->ticker = async::details::tick_after(this->shared_from_this(), this->timer, this->executor, this->quiet - (now - this->last));
+						return;
+					}
+
+					this->debounced->emitShared(std::move(this->latest));
+					this->latest = nullptr;
+				}
+
+				/**
+				 * Emit the value waiting for the quiet period (if any), then close the debounced stream
+				 */
+				void close(){
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+						this->closed = true;
+
+						if(this->armed)
+							this->timer->cancel(this->ticker);
+
+						if(this->latest)
+							this->debounced->emitShared(std::move(this->latest));
+					}
+
+					this->debounced->close();
+				}
+		};
+
+		/**
+		 * The state of async::stream<T>::sample, the latest value is emitted periodically
+		 * @tparam T - The type of the values
+		 */
+		template <class T>
+		class sample_state : public std::enable_shared_from_this<sample_state<T>>{
+			public:
+				using shared_value = std::shared_ptr<const T>;///< @typedef shared_value being the type of values sampled
+				using output_stream = std::shared_ptr<async::stream<T>>;///< @typedef output_stream being the type of stream the samples go to
+
+			protected:
+				std::mutex mutex{};///< @property mutex being the mutex used to lock the state
+				shared_value latest = nullptr;///< @property latest being the latest value received since the last sample (if any)
+				bool closed = false;///< @property closed being whether or not the source stream is done
+				output_stream sampled;///< @property sampled being the stream the samples go to
+				shared_timer timer;///< @property timer being the timer that measures the periods
+				async::timer::timer_id ticker = 0;///< @property ticker being the handle of the periodic tick
+
+			public:
+				sample_state(output_stream sampled, shared_timer timer)
+				: sampled{std::move(sampled)}, timer{std::move(timer)}{
+				}
+
+				/**
+				 * Start sampling
+				 * @param executor being the executor the samples are emitted from
+				 * @param period being the delay between two samples
+				 */
+				void start(const shared_executor& executor, async::timer::duration period){
+					std::lock_guard<std::mutex> _{this->mutex};
+					this->ticker = async::details::tick_every(this->shared_from_this(), this->timer, executor, period);
+				}
+
+				/**
+				 * Replace the latest value
+				 * @param value being the value that arrived
+				 */
+				void push(shared_value value){
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(!this->closed)
+						this->latest = std::move(value);
+				}
+
+				/**
+				 * Emit the latest value, unless none has arrived since the last sample
+				 */
+				void tick(){
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(this->closed || !this->latest)
+						return;
+
+					this->sampled->emitShared(std::move(this->latest));
+					this->latest = nullptr;
+				}
+
+				/**
+				 * Stop sampling, emit the value received since the last sample (if any), then close the sampled stream
+				 */
+				void close(){
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+						this->closed = true;
+						this->timer->cancel(this->ticker);
+
+						if(this->latest)
+							this->sampled->emitShared(std::move(this->latest));
+					}
+
+					this->sampled->close();
+				}
+		};
+
+		/**
+		 * The state of async::stream<T>::timeout, values go through until none arrives for too long
+		 * @tparam T - The type of the values
+		 */
+		template <class T>
+		class timeout_state : public std::enable_shared_from_this<timeout_state<T>>{
+			public:
+				using output_stream = std::shared_ptr<async::stream<T>>;///< @typedef output_stream being the type of stream the values go to
+				using duration = async::timer::duration;///< @typedef duration being the type of the time limit
+				using handler_type = std::function<void()>;///< @typedef handler_type being the type of function invoked on timeout
+
+			protected:
+				std::mutex mutex{};///< @property mutex being the mutex used to lock the state
+				async::timer::time_point last{};///< @property last being when the latest value has arrived
+				const duration limit;///< @property limit being how long without a value is tolerated
+				bool expired = false;///< @property expired being whether or not the time limit has been exceeded
+				bool closed = false;///< @property closed being whether or not the source stream is done
+				output_stream guarded;///< @property guarded being the stream the values go to
+				shared_timer timer;///< @property timer being the timer that measures the time limit
+				shared_executor executor;///< @property executor being the executor the timeout is handled on
+				async::timer::timer_id ticker = 0;///< @property ticker being the handle of the scheduled tick
+				handler_type onTimeout;///< @property onTimeout being the function invoked on timeout (if any)
+
+			public:
+				timeout_state(duration limit, output_stream guarded, shared_timer timer, shared_executor executor, handler_type onTimeout)
+				: limit{limit}, guarded{std::move(guarded)}, timer{std::move(timer)}, executor{std::move(executor)}, onTimeout{std::move(onTimeout)}{
+				}
+
+				/**
+				 * Start measuring the time limit
+				 */
+				void start(){
+					std::lock_guard<std::mutex> _{this->mutex};
+					this->last = async::timer::now();
+					this->ticker = async::details::tick_after(this->shared_from_this(), this->timer, this->executor, this->limit);
+				}
+
+				/**
+				 * Forward a value or a batch, unless the time limit has been exceeded (the tick is not rescheduled per value)
+				 * @tparam Value - The type of shared value or batch
+				 * @param value being what arrived
+				 */
+				template <class Value>
+				void push(const Value& value){
+					const auto now = async::timer::now();
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(this->expired || this->closed)
+						return;
+
+					this->last = now;
+					this->guarded->emitShared(value);
+				}
+
+				/**
+				 * Close the guarded stream if no value has arrived within the time limit, wait for the rest of it otherwise
+				 */
+				void tick(){
+					const auto now = async::timer::now();
+					handler_type handler;
+
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+
+						if(this->expired || this->closed)
+							return;
+
+						if(now - this->last < this->limit){
+							this->ticker = async::details::tick_after(this->shared_from_this(), this->timer, this->executor, this->limit - (now - this->last));
+							return;
+						}
+
+						this->expired = true;
+						handler = std::move(this->onTimeout);
+					}
+
+					this->guarded->close();
+
+					if(handler)
+						handler();
+				}
+
+				/**
+				 * Stop measuring the time limit, then close the guarded stream (unless the time limit already did)
+				 */
+				void close(){
+					bool expired;
+
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+						this->closed = true;
+						this->timer->cancel(this->ticker);
+						expired = this->expired;
+					}
+
+					if(!expired)
+						this->guarded->close();
+				}
+		};
+
+		/**
+		 * The state of async::stream<T>::delay, values are held in arrival order until their delay has elapsed
+		 * @tparam T - The type of the values
+		 */
+		template <class T>
+		class delay_state : public std::enable_shared_from_this<delay_state<T>>{
+			public:
+				using shared_value = std::shared_ptr<const T>;///< @typedef shared_value being the type of values delayed
+				using shared_batch = std::shared_ptr<const async::batch<T>>;///< @typedef shared_batch being the type of batches delayed
+				using output_stream = std::shared_ptr<async::stream<T>>;///< @typedef output_stream being the type of stream the values go to
+				using duration = async::timer::duration;///< @typedef duration being the type of the delay
+
+			protected:
+				/**
+				 * A value or a batch waiting for its delay to elapse
+				 */
+				struct pending_type{
+					async::timer::time_point due;///< @property due being when it is emitted
+					shared_value value;///< @property value being the single value (if any)
+					shared_batch batch;///< @property batch being the batch of values (if any)
+				};
+
+				std::mutex mutex{};///< @property mutex being the mutex used to lock the state
+				std::deque<pending_type> pending{};///< @property pending being what waits for its delay to elapse (sorted by due time since the delay is constant)
+				const duration lag;///< @property lag being the delay of each value
+				bool armed = false;///< @property armed being whether or not a tick has been scheduled
+				bool closing = false;///< @property closing being whether or not the source stream is done
+				output_stream delayed;///< @property delayed being the stream the values go to
+				shared_timer timer;///< @property timer being the timer that measures the delays
+				shared_executor executor;///< @property executor being the executor the values are emitted from
+				std::shared_ptr<delay_state> keepAlive;///< @property keepAlive being this state while values are pending (the source stream may be gone before they are due)
+
+				/**
+				 * Schedule a tick for the first pending value (a single tick is scheduled at a time)
+				 * @param now being the current time
+				 */
+				void arm(async::timer::time_point now){
+					this->armed = true;
+					this->keepAlive = this->shared_from_this();
+					async::details::tick_after(this->shared_from_this(), this->timer, this->executor, this->pending.front().due - now);
+				}
+
+			public:
+				delay_state(duration lag, output_stream delayed, shared_timer timer, shared_executor executor)
+				: lag{lag}, delayed{std::move(delayed)}, timer{std::move(timer)}, executor{std::move(executor)}{
+				}
+
+				/**
+				 * Hold a value or a batch until its delay has elapsed
+				 * @param value being the single value (if any)
+				 * @param batch being the batch of values (if any)
+				 */
+				void push(shared_value value, shared_batch batch){
+					const auto now = async::timer::now();
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					this->pending.push_back(pending_type{now + this->lag, std::move(value), std::move(batch)});
+
+					if(!this->armed)
+						this->arm(now);
+				}
+
+				/**
+				 * Emit what is due, then schedule a tick for what remains (or close the delayed stream once the source stream is done)
+				 */
+				void tick(){
+					const auto now = async::timer::now();
+					std::shared_ptr<delay_state> released;
+					bool done;
+
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+						this->armed = false;
+
+						for(; !this->pending.empty() && this->pending.front().due <= now ; this->pending.pop_front()){
+							auto& front = this->pending.front();
+
+							if(front.batch)
+								this->delayed->emitShared(std::move(front.batch));
+							else
+								this->delayed->emitShared(std::move(front.value));
+						}
+
+						if(!this->pending.empty())
+							this->arm(now);
+						else
+							released = std::move(this->keepAlive);
+
+						done = this->closing && this->pending.empty();
+					}
+
+					if(done)
+						this->delayed->close();
+				}
+
+				/**
+				 * Close the delayed stream once what is pending has been emitted
+				 */
+				void close(){
+					bool done;
+
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+						this->closing = true;
+						done = this->pending.empty();
+					}
+
+					if(done)
+						this->delayed->close();
+				}
+		};
+	}
+}
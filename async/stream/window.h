@@ -0,0 +1,341 @@
+#pragma once
+#include <async/stream/fwd.h>
+#include <async/executor/fwd.h>
+#include <async/timer/decl.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <utility>
+
+namespace async{
+	namespace details{
+		/**
+		 * Make a timer tick a window periodically, on the given executor (the timer thread itself never runs operators)
+		 * @tparam State - The type of window state, State::tick is invoked on each period
+		 * @param state being the state to tick (ticks stop as soon as it is destroyed)
+		 * @param timer being the timer that measures the periods
+		 * @param executor being the executor the ticks are run on
+		 * @param period being the delay between two ticks
+		 * @return the handle to give to async::timer::cancel
+		 */
+		template <class State>
+		async::timer::timer_id tick_every(const std::shared_ptr<State>& state, const shared_timer& timer, const shared_executor& executor, async::timer::duration period){
+			std::weak_ptr<State> weak = state;
+
+			return timer->scheduleEvery(period, [weak, executor]{
+				executor->execute([weak]{
+					if(auto alive = weak.lock())
+						alive->tick();
+				});
+			});
+		}
+
+		/**
+		 * Make a timer tick a state once, on the given executor (the timer thread itself never runs operators)
+		 * @tparam State - The type of state, State::tick is invoked once the delay has elapsed
+		 * @param state being the state to tick (the tick is skipped if it has been destroyed meanwhile)
+		 * @param timer being the timer that measures the delay
+		 * @param executor being the executor the tick is run on
+		 * @param delay being the delay before the tick
+		 * @return the handle to give to async::timer::cancel
+		 */
+		template <class State>
+		async::timer::timer_id tick_after(const std::shared_ptr<State>& state, const shared_timer& timer, const shared_executor& executor, async::timer::duration delay){
+			std::weak_ptr<State> weak = state;
+
+			return timer->schedule(delay, [weak, executor]{
+				executor->execute([weak]{
+					if(auto alive = weak.lock())
+						alive->tick();
+				});
+			});
+		}
+
+		/**
+		 * The state of async::stream<T>::window over a count of values
+		 * @tparam T - The type of the values to group
+		 */
+		template <class T>
+		class count_window_state{
+			public:
+				using window_type = std::vector<T>;///< @typedef window_type being the type of the groups of values emitted
+				using output_stream = std::shared_ptr<async::stream<window_type>>;///< @typedef output_stream being the type of stream the windows go to
+
+			protected:
+				std::mutex mutex{};///< @property mutex being the mutex used to lock the state
+				std::deque<T> values{};///< @property values being the last values received (at most size of them)
+				const std::size_t size;///< @property size being the amount of values of a window
+				const std::size_t step;///< @property step being the amount of values between the starts of two windows
+				std::size_t seen = 0;///< @property seen being the amount of values received
+				output_stream windowed;///< @property windowed being the stream the windows go to
+
+			public:
+				count_window_state(std::size_t size, std::size_t step, output_stream windowed)
+				: size{size}, step{step}, windowed{std::move(windowed)}{
+				}
+
+				/**
+				 * Add values to the windows, emitting the windows they complete
+				 * @tparam Iterator - The type of iterator over the values
+				 * @param first being the first value
+				 * @param last being past the last value
+				 */
+				template <class Iterator>
+				void push(Iterator first, Iterator last){
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					for(; first != last ; ++first){
+						this->values.push_back(*first);
+						if(this->values.size() > this->size)
+							this->values.pop_front();
+
+						//The window started at k * step is complete once size values have been received since
+						if(++this->seen >= this->size && (this->seen - this->size) % this->step == 0)
+							this->windowed->emit(window_type(this->values.begin(), this->values.end()));
+					}
+				}
+
+				/**
+				 * Emit the windows that have started but are not complete, then close the stream of windows
+				 */
+				void close(){
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+
+						std::size_t start = this->seen >= this->size ? ((this->seen - this->size) / this->step + 1) * this->step : 0;
+						for(; start < this->seen ; start += this->step)
+							this->windowed->emit(window_type(this->values.end() - (this->seen - start), this->values.end()));
+					}
+
+					this->windowed->close();
+				}
+		};
+
+		/**
+		 * The state of async::stream<T>::window over a duration
+		 * @tparam T - The type of the values to group
+		 */
+		template <class T>
+		class time_window_state{
+			public:
+				using window_type = std::vector<T>;///< @typedef window_type being the type of the groups of values emitted
+				using output_stream = std::shared_ptr<async::stream<window_type>>;///< @typedef output_stream being the type of stream the windows go to
+				using time_point = async::timer::time_point;///< @typedef time_point being the type of arrival times
+				using duration = async::timer::duration;///< @typedef duration being the type of the lengths of windows
+
+			protected:
+				std::mutex mutex{};///< @property mutex being the mutex used to lock the state
+				std::deque<std::pair<time_point, T>> values{};///< @property values being the values of the current window(s), along with their arrival time
+				const duration size;///< @property size being the length of a window
+				const duration step;///< @property step being the delay between the ends of two windows
+				bool fresh = false;///< @property fresh being whether or not values have been received since the last window
+				bool closed = false;///< @property closed being whether or not the source stream is done
+				output_stream windowed;///< @property windowed being the stream the windows go to
+				shared_timer timer;///< @property timer being the timer that ends the windows
+				async::timer::timer_id ticker = 0;///< @property ticker being the handle of the periodic tick
+
+				/**
+				 * Forget the values that have left every window
+				 * @param now being the current time
+				 */
+				void trim(time_point now){
+					//Tumbling windows are emptied by each tick instead: a late tick must not lose values
+					if(this->step >= this->size)
+						return;
+
+					while(!this->values.empty() && now - this->values.front().first > this->size)
+						this->values.pop_front();
+				}
+
+				/**
+				 * Emit the values of the current window (if any)
+				 */
+				void flush(){
+					if(this->values.empty())
+						return;
+
+					window_type window;
+					window.reserve(this->values.size());
+					for(const auto& value : this->values)
+						window.push_back(value.second);
+
+					//Tumbling windows do not overlap
+					if(this->step >= this->size)
+						this->values.clear();
+
+					this->fresh = false;
+					this->windowed->emit(std::move(window));
+				}
+
+			public:
+				time_window_state(duration size, duration step, output_stream windowed, shared_timer timer)
+				: size{size}, step{step}, windowed{std::move(windowed)}, timer{std::move(timer)}{
+				}
+
+				/**
+				 * Start ending windows
+				 * @param self being this state
+				 * @param executor being the executor the windows are emitted from
+				 */
+				void start(const std::shared_ptr<time_window_state>& self, const shared_executor& executor){
+					std::lock_guard<std::mutex> _{this->mutex};
+					this->ticker = async::details::tick_every(self, this->timer, executor, this->step);
+				}
+
+				/**
+				 * Add values to the current window(s)
+				 * @tparam Iterator - The type of iterator over the values
+				 * @param first being the first value
+				 * @param last being past the last value
+				 */
+				template <class Iterator>
+				void push(Iterator first, Iterator last){
+					const auto now = async::timer::now();
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(this->closed)
+						return;
+
+					this->trim(now);
+					for(; first != last ; ++first)
+						this->values.emplace_back(now, *first);
+
+					this->fresh = true;
+				}
+
+				/**
+				 * End the current window, emitting its values (empty windows are skipped)
+				 */
+				void tick(){
+					const auto now = async::timer::now();
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(this->closed)
+						return;
+
+					this->trim(now);
+					this->flush();
+				}
+
+				/**
+				 * Stop ending windows, emit the values received since the last window, then close the stream of windows
+				 */
+				void close(){
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+						this->closed = true;
+						this->timer->cancel(this->ticker);
+
+						if(this->fresh)
+							this->flush();
+					}
+
+					this->windowed->close();
+				}
+		};
+
+		/**
+		 * The state of async::stream<T>::windowReduce, values are folded as they arrive instead of being kept
+		 * @tparam T - The type of the values to fold
+		 * @tparam Accumulator - The type of the aggregate of a window
+		 * @tparam Reducer - Reducer :: (Accumulator, const T&) -> Accumulator
+		 */
+		template <class T, class Accumulator, class Reducer>
+		class fold_window_state{
+			public:
+				using output_stream = std::shared_ptr<async::stream<Accumulator>>;///< @typedef output_stream being the type of stream the aggregates go to
+
+			protected:
+				std::mutex mutex{};///< @property mutex being the mutex used to lock the state
+				Reducer reducer;///< @property reducer being the function used to fold a value into the aggregate
+				const Accumulator identity;///< @property identity being the aggregate of an empty window
+				Accumulator accumulator;///< @property accumulator being the aggregate of the current window
+				std::size_t count = 0;///< @property count being the amount of values of the current window
+				const std::size_t size;///< @property size being the amount of values of a window (0 if windows are ended by the timer)
+				bool closed = false;///< @property closed being whether or not the source stream is done
+				output_stream aggregated;///< @property aggregated being the stream the aggregates go to
+				shared_timer timer = nullptr;///< @property timer being the timer that ends the windows (if any)
+				async::timer::timer_id ticker = 0;///< @property ticker being the handle of the periodic tick
+
+				/**
+				 * Emit the aggregate of the current window (unless it is empty) and start a new one
+				 */
+				void flush(){
+					if(this->count == 0)
+						return;
+
+					this->aggregated->emit(std::move(this->accumulator));
+					this->accumulator = this->identity;
+					this->count = 0;
+				}
+
+			public:
+				fold_window_state(Reducer reducer, Accumulator identity, std::size_t size, output_stream aggregated)
+				: reducer(std::move(reducer)), identity(identity), accumulator(std::move(identity)), size{size}, aggregated{std::move(aggregated)}{
+				}
+
+				/**
+				 * Start ending windows periodically
+				 * @param self being this state
+				 * @param timer being the timer that measures the periods
+				 * @param executor being the executor the aggregates are emitted from
+				 * @param period being the length of a window
+				 */
+				void start(const std::shared_ptr<fold_window_state>& self, shared_timer timer, const shared_executor& executor, async::timer::duration period){
+					std::lock_guard<std::mutex> _{this->mutex};
+					this->timer = std::move(timer);
+					this->ticker = async::details::tick_every(self, this->timer, executor, period);
+				}
+
+				/**
+				 * Fold values into the current window, emitting the windows they complete
+				 * @tparam Iterator - The type of iterator over the values
+				 * @param first being the first value
+				 * @param last being past the last value
+				 */
+				template <class Iterator>
+				void push(Iterator first, Iterator last){
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(this->closed)
+						return;
+
+					for(; first != last ; ++first){
+						this->accumulator = this->reducer(std::move(this->accumulator), *first);
+
+						if(++this->count == this->size)
+							this->flush();
+					}
+				}
+
+				/**
+				 * End the current window
+				 */
+				void tick(){
+					std::lock_guard<std::mutex> _{this->mutex};
+
+					if(!this->closed)
+						this->flush();
+				}
+
+				/**
+				 * Stop ending windows, emit the aggregate of the current window, then close the stream of aggregates
+				 */
+				void close(){
+					{
+						std::lock_guard<std::mutex> _{this->mutex};
+						this->closed = true;
+
+						if(this->timer)
+							this->timer->cancel(this->ticker);
+
+						this->flush();
+					}
+
+					this->aggregated->close();
+				}
+		};
+	}
+}
@@ -1,12 +1,17 @@
 #pragma once
 #include <async/task/fwd.h>
 #include <async/stream/decl.h>
+#include <async/executor/fwd.h>
+#include <async/completion/decl.h>
+#include <async/stop/decl.h>
 //#include <thread>
 #include <future>
 #include <functional>
 #include <memory>
 #include <atomic>
 #include <exception>
+#include <mutex>
+#include <vector>
 
 /**
  * A task that uses a stream to interact with the world
@@ -16,15 +21,16 @@ template <class T>
 class async::task{
 	public:
 		using task_t = task; ///< @typedef task_t being the type of this task
-		using stream_t = stream<T>; ///< @typedef stream_t being the type of stream associated to tasks
+		using stream_t = async::stream<T>; ///< @typedef stream_t being the type of stream associated to tasks
 		using runner_t = std::future<void>/*std::thread*/; ///< @typedef runner_t being the type used to run the task
 		using runner_ptr_t = std::unique_ptr<runner_t>; ///< @typedef runner_ptr_t being the ptr type to the task runner
 		using value_t = typename stream_t::value_type; ///< @typedef value_t being the type of values streamed
 		using handler_t = std::function<void(task_t&, stream_t&)>; ///< @typedef handler_t being the type of handler to provided to the task
 		using shared_stream = typename stream_t::shared_stream; ///< @typedef shared_stream being the type of shared stream associated to this task
+		using shared_executor = async::shared_executor; ///< @typedef shared_executor being the type of executor used to run the task
 
 		/**
-		 * An exception class used to stop a task
+		 * An exception class a handler may throw to unwind itself (async::task<T>::stop does not throw anymore)
 		 */
 		class stopping_task final : public std::exception{
 			protected:
@@ -54,9 +60,11 @@ class async::task{
 
 	protected:
 		runner_ptr_t runner = nullptr; ///< @property thread being the task launcher
-		shared_stream stream_ptr{new stream_t{}}; ///< @property stream_ptr being the pointer to the stream of this task
+		shared_executor executor_ptr; ///< @property executor_ptr being the executor the handler is run on
+		shared_stream stream_ptr; ///< @property stream_ptr being the pointer to the stream of this task
 		handler_t handler; ///< @property handler being the handler for this task
 		std::atomic_bool running{false}; ///< @property running being the flag determining whether or not the task has been completed
+		std::atomic<const char*> stopReason{nullptr}; ///< @property stopReason being why the task has been asked to stop (if given)
 
 		/**
 		 * Setter for the running flag
@@ -92,11 +100,33 @@ class async::task{
 		task& operator=(task&& other) noexcept = default;
 
 		/**
-		 * Construct a task from its handler
+		 * Construct a task from its handler, run on async::default_task_executor
 		 * @param handler being the function to invoke in order to execute the task
+		 * @warning The handler should not block for long (see async::default_task_executor)
 		 */
 		task(handler_t handler);
 
+		/**
+		 * Construct a task from its handler and the executors it relies on
+		 * @param handler being the function to invoke in order to execute the task
+		 * @param executor being the executor the handler is run on
+		 * @param streamExecutor being the executor used to deliver the values of the associated stream
+		 */
+		task(handler_t handler, shared_executor executor, shared_executor streamExecutor = nullptr);
+
+		/**
+		 * Construct a task from its handler, the executor it runs on and the settings of its stream
+		 * @param handler being the function to invoke in order to execute the task
+		 * @param executor being the executor the handler is run on
+		 * @param streamOptions being the settings of the associated stream (eg. the resource its values are allocated from)
+		 */
+		task(handler_t handler, shared_executor executor, const async::stream_options& streamOptions);
+
+		/**
+		 * Destructor, waits for the handler to return
+		 */
+		~task();
+
 		/**
 		 * Determine whether or not this task is running
 		 * @return TRUE if running, FALSE otherwise
@@ -113,28 +143,42 @@ class async::task{
 		task& run();
 
 		/**
-		 * Stops this task mid-execution without a specific error message
+		 * Ask this task to stop, from its handler or from any other thread, without throwing
 		 * @return a reference to this task
-		 * @throws async::task<T>::stopping_task
-		 * @warning closes the associated stream
+		 * @warning cooperative: the handler is expected to check async::task<T>::stopRequested (or the stream's) and return, which closes the associated stream
 		 *
-		 * @pre This task is running
-		 * @post This task is not running, this task has been stopped
+		 * @post A stop has been requested on the task, its stream and the streams derived from it
 		 */
 		task& stop();
 
 		/**
-		 * Stops this task mid-execution with the specified error message
-		 * @param cstr - The error message used to stop the stream associated to this task
+		 * Ask this task to stop with the specified reason (logged when ASYNC_TASK_DEBUG is defined)
+		 * @param cstr - Why the task is being stopped (must outlive the task)
 		 * @return a reference to this task
-		 * @throws async::task<T>::stopping_task
-		 * @warning closes the associated stream
+		 * @warning cooperative: the handler is expected to check async::task<T>::stopRequested (or the stream's) and return, which closes the associated stream
 		 *
-		 * @pre This task is running
-		 * @post This task is not running, this task has been stopped
+		 * @post A stop has been requested on the task, its stream and the streams derived from it
 		 */
 		task& stop(const char* cstr);
 
+		/**
+		 * Determine whether or not this task has been asked to stop (a single atomic load)
+		 * @return TRUE if a stop has been requested on the task or on its pipeline, FALSE otherwise
+		 */
+		bool stopRequested() const{ return this->stream_ptr->stopRequested(); }
+
+		/**
+		 * Get the source of the stop requests of this task (shared with its stream and the streams derived from it)
+		 * @return the stop source
+		 */
+		async::stop_source stopSource() const{ return this->stream_ptr->stopSource(); }
+
+		/**
+		 * Get a token to check for or react to a stop request (see async::stop_callback)
+		 * @return a token associated to the stop source of this task
+		 */
+		async::stop_token stopToken() const{ return this->stream_ptr->stopToken(); }
+
 		/**
 		 * Waits for the completion (or failure) of this task
 		 * @return a reference to this task
@@ -150,6 +194,12 @@ class async::task{
 		 */
 		shared_stream stream() const{ return this->stream_ptr; }
 
+		/**
+		 * Get the executor this task is run on
+		 * @return a shared_ptr to the executor of this task
+		 */
+		shared_executor executor() const{ return this->executor_ptr; }
+
 		/**
 		 * Interoperability with pointers to tasks
 		 * @return a pointer to this task
@@ -158,11 +208,78 @@ class async::task{
 
 	protected:
 		/**
-		 * Modify the internals of this task to be in a stopped state
+		 * Modify the internals of this task to be in a stopped state, once the handler has returned
 		 * @warning closes the associated stream
 		 *
 		 * @pre This task is running
 		 * @post This task state has been set to a stopped state
 		 */
 		void stop_internals();
-};
\ No newline at end of file
+};
+
+/**
+ * A set of jobs and tasks that can be waited on collectively
+ */
+class async::task_group{
+	public:
+		using job_type = std::function<void()>; ///< @typedef job_type being the type of jobs run by the group
+		using shared_executor = async::shared_executor; ///< @typedef shared_executor being the type of executor the jobs are run on
+
+	protected:
+		/**
+		 * What the jobs of the group share with it (they may outlive it by a few instructions)
+		 */
+		struct state_type{
+			async::details::park_word pending{0}; ///< @property pending being the amount of jobs not done yet
+			std::mutex mutex{}; ///< @property mutex being the mutex used to lock the error
+			std::exception_ptr error{}; ///< @property error being the first exception thrown by a job
+		};
+
+		shared_executor executor_ptr; ///< @property executor_ptr being the executor the jobs are run on
+		std::shared_ptr<state_type> state; ///< @property state being the state shared with the jobs
+		std::vector<std::function<void()>> waiters{}; ///< @property waiters being the functions that wait for the tasks of the group
+
+	public:
+		/**
+		 * Construct an empty group
+		 * @param executor being the executor to run jobs on (nullptr means async::default_task_executor)
+		 */
+		explicit task_group(shared_executor executor = nullptr);
+
+		task_group(const task_group&) = delete;
+		task_group& operator=(const task_group&) = delete;
+
+		/**
+		 * Destructor, waits for the jobs and tasks of the group (their exceptions are discarded)
+		 */
+		~task_group();
+
+		/**
+		 * Run a job as part of this group
+		 * @param job being the job to run
+		 * @return a reference to this group
+		 */
+		task_group& run(job_type job);
+
+		/**
+		 * Run a task as part of this group
+		 * @tparam T - The type of data that flows in the stream of the task
+		 * @param task being the task to run (it must outlive the call to async::task_group::wait)
+		 * @return a reference to this group
+		 */
+		template <class T>
+		task_group& run(async::task<T>& task);
+
+		/**
+		 * Wait for every job and task of this group (a worker of the executor runs pending jobs meanwhile)
+		 * @return a reference to this group
+		 * @throws the first exception thrown by a job or task of the group
+		 */
+		task_group& wait();
+
+		/**
+		 * Retrieve the amount of jobs not done yet
+		 * @return the amount of pending jobs
+		 */
+		std::size_t pending() const{ return this->state->pending.load(); }
+};
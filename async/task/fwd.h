@@ -3,4 +3,6 @@
 namespace async{
 	template <class T>
 	class task;
+
+	class task_group;
 }
\ No newline at end of file
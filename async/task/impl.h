@@ -1,11 +1,19 @@
 #pragma once
 #include <async/task/decl.h>
 #include <async/stream/stream.hpp>
+#include <async/executor/executor.hpp>
+#include <async/completion/completion.hpp>
+#include <chrono>
 
 #ifdef ASYNC_TASK_DEBUG
 #include <iostream>
 #endif
 
+#ifdef ASYNC_TRACE
+#include <async/trace/trace.hpp>
+#include <cstdint>
+#endif
+
 
 #define constructor task
 #define self async::task<T>
@@ -13,7 +21,23 @@
 #define TPL template <class T>
 
 TPL
-self::constructor(self_t::handler_t handler) : handler{handler}{
+self::constructor(self_t::handler_t handler) : constructor(handler, async::default_task_executor()){
+}
+
+TPL
+self::constructor(self_t::handler_t handler, self_t::shared_executor executor, self_t::shared_executor streamExecutor)
+: executor_ptr{executor ? executor : async::default_task_executor()}, stream_ptr{new stream_t{streamExecutor}}, handler{handler}{
+}
+
+TPL
+self::constructor(self_t::handler_t handler, self_t::shared_executor executor, const async::stream_options& streamOptions)
+: executor_ptr{executor ? executor : async::default_task_executor()}, stream_ptr{new stream_t{streamOptions}}, handler{handler}{
+}
+
+TPL
+self::~constructor(){
+	if(this->runner && this->runner->valid())
+		this->runner->wait();
 }
 
 TPL
@@ -21,11 +45,22 @@ self& self::run(){
 	if(this->is_running())
 		return *this;
 
-	this->runner = this->make_runner([&]{
+	this->set_running(true);
+	this->runner = this->make_runner([this]{
+		#ifdef ASYNC_TRACE
+		async::trace::record(async::trace::event_kind::task_start, this, reinterpret_cast<std::uintptr_t>(this->stream_ptr.get()));
+		#endif
+
 		try{
 			self& task = *this;
 			self_t::stream_t& stream = *(this->stream_ptr);
 			this->handler(task, stream);
+			this->stop_internals();
+
+			#ifdef ASYNC_TASK_DEBUG
+			if(const char* reason = this->stopReason.load())
+				std::cerr << reason << '\n';
+			#endif
 		}catch(const self_t::stopping_task& e){
 			this->stop_internals();
 			#ifdef ASYNC_TASK_DEBUG
@@ -37,52 +72,57 @@ self& self::run(){
 		}
 	});
 
-	this->set_running(true);
 	return *this;
 }
 
 TPL
 self& self::stop(){
-	if(!this->is_running())
-		return *this;
-
-	this->stop_internals();
-	throw stopping_task{};
+	this->stream_ptr->requestStop();
+	return *this;
 }
 
 TPL
 self& self::stop(const char* cstr){
-	if(!this->is_running())
-		return *this;
-
-	this->stop_internals();
-	throw stopping_task{cstr};
+	const char* expected = nullptr;
+	this->stopReason.compare_exchange_strong(expected, cstr);
+	return this->stop();
 }
 
 TPL
 void self::stop_internals(){
+	#ifdef ASYNC_TRACE
+	async::trace::record(async::trace::event_kind::task_stop, this);
+	#endif
+
 	this->set_running(false);
 	this->stream_ptr->close();
 }
 
 TPL
 self& self::wait(){
-	if(!this->is_running())
+	if(!this->runner)
 		return *this;
 
-	if(this->runner)
+	if(this->runner->valid()){
+		//A worker waiting for a task queued on its own executor runs the pending jobs meanwhile
+		if(this->executor_ptr->owns_current_thread()){
+			while(this->runner->wait_for(std::chrono::seconds{0}) != std::future_status::ready){
+				if(!this->executor_ptr->run_pending())
+					this->runner->wait_for(std::chrono::milliseconds{1});
+			}
+		}
+
 		this->runner->get();
+	}
 
+	this->stream_ptr->wait();
 	return *this;
 }
 
 TPL
 template <class F>
 self_t::runner_ptr_t self::make_runner(F handler){
-	auto handled = std::async(
-		std::launch::async,
-		handler
-	);
+	auto handled = this->executor_ptr->submit(handler);
 
 	return self_t::runner_ptr_t{
 		new self_t::runner_t(std::move(handled))
@@ -103,4 +143,89 @@ const char* self::stopping_task::what() const noexcept { return this->_what; }
 #undef constructor
 #undef self
 #undef self_t
-#undef TPL
\ No newline at end of file
+#undef TPL
+
+
+#define self async::task_group
+#define constructor task_group
+
+inline self::constructor(self::shared_executor executor)
+: executor_ptr{executor ? executor : async::default_task_executor()}, state{std::make_shared<state_type>()}{
+}
+
+inline self::~constructor(){
+	try{
+		this->wait();
+	}catch(...){
+	}
+}
+
+inline self& self::run(self::job_type job){
+	auto state = this->state;
+	++state->pending;
+
+	this->executor_ptr->execute([state, job]{
+		try{
+			job();
+		}catch(...){
+			std::lock_guard<std::mutex> _{state->mutex};
+			if(!state->error)
+				state->error = std::current_exception();
+		}
+
+		if(state->pending.fetch_sub(1) == 1)
+			async::details::unpark_all(state->pending);
+	});
+
+	return *this;
+}
+
+template <class T>
+self& self::run(async::task<T>& task){
+	task.run();
+	this->waiters.push_back([&task]{
+		task.wait();
+	});
+
+	return *this;
+}
+
+inline self& self::wait(){
+	const bool helping = this->executor_ptr->owns_current_thread();
+	const std::chrono::nanoseconds tick = std::chrono::milliseconds{1};
+
+	for(auto pending = this->state->pending.load() ; pending != 0 ; pending = this->state->pending.load()){
+		if(helping && this->executor_ptr->run_pending())
+			continue;
+
+		//Workers only doze off: more jobs may be queued behind them
+		async::details::park(this->state->pending, pending, helping ? &tick : nullptr);
+	}
+
+	auto waiters = std::move(this->waiters);
+	this->waiters.clear();
+
+	for(auto& waiter : waiters){
+		try{
+			waiter();
+		}catch(...){
+			std::lock_guard<std::mutex> _{this->state->mutex};
+			if(!this->state->error)
+				this->state->error = std::current_exception();
+		}
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> _{this->state->mutex};
+		std::swap(error, this->state->error);
+	}
+
+	if(error)
+		std::rethrow_exception(error);
+
+	return *this;
+}
+
+#undef self
+#undef constructor
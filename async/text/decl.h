@@ -0,0 +1,145 @@
+#pragma once
+#include <async/text/fwd.h>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @namespace async::text
+ * Operators over lines of text (any type with data() and size(), eg. std::string or async::line_view), usable as stream stages
+ * (filter, filterMap) without regular expressions nor exceptions
+ */
+namespace async{
+	namespace text{
+		/**
+		 * Why a text could not be parsed
+		 */
+		enum class parse_error{
+			none, ///< The text has been parsed
+			empty, ///< The text is empty
+			invalid, ///< The text is not a number of the requested kind
+			out_of_range ///< The number does not fit in the requested type
+		};
+
+		/**
+		 * The outcome of a parse
+		 * @tparam T The type of the parsed value
+		 */
+		template <class T>
+		struct parse_result{
+			T value; ///< @property value being the parsed value (meaningless if error is not async::text::parse_error::none)
+			parse_error error; ///< @property error being why the text could not be parsed (if so)
+
+			explicit operator bool() const{ return this->error == parse_error::none; }
+		};
+
+		/**
+		 * Determine whether or not a text only holds whitespace (" \t\n\v\f\r"), 16 bytes at a time
+		 * @param first being the first character
+		 * @param last being the end of the text
+		 * @return TRUE if the text is empty or blank, FALSE otherwise
+		 */
+		inline bool is_blank(const char* first, const char* last);
+
+		/**
+		 * Determine whether or not a text is a base 10 integer (an optional '-' followed by digits), 16 bytes at a time
+		 * @param first being the first character
+		 * @param last being the end of the text
+		 * @return TRUE if the text is an integer, FALSE otherwise
+		 */
+		inline bool is_integer(const char* first, const char* last);
+
+		/**
+		 * Parse a base 10 integer spanning the whole text (like std::from_chars, without exceptions)
+		 * @tparam T - An integral type
+		 * @param first being the first character
+		 * @param last being the end of the text
+		 * @return the parsed value, or why it could not be parsed
+		 */
+		template <class T>
+		parse_result<T> parse_integer(const char* first, const char* last);
+
+		/**
+		 * Parse a decimal floating point number spanning the whole text ([-]digits[.digits][(e|E)[+|-]digits], without exceptions)
+		 * @tparam T - A floating point type
+		 * @param first being the first character
+		 * @param last being the end of the text
+		 * @return the parsed value, or why it could not be parsed
+		 *
+		 * @warning Numbers beyond the exact fast path (more than 19 significant digits or a large exponent) go through std::strtof, std::strtod or std::strtold (by T), which follow the C locale
+		 */
+		template <class T>
+		parse_result<T> parse_float(const char* first, const char* last);
+
+		/**
+		 * Parse a number of the given type spanning the whole text
+		 * @tparam T - An arithmetic type
+		 * @tparam Text - A type with data() and size()
+		 * @param text being the text to parse
+		 * @return the parsed value, or why it could not be parsed
+		 */
+		template <class T, class Text>
+		parse_result<T> parse(const Text& text);
+
+		/**
+		 * Retrieve a human readable description of a parse error
+		 * @param error being the error
+		 * @return the description
+		 */
+		inline const char* describe(parse_error error);
+
+		/**
+		 * A predicate matching blank texts
+		 */
+		struct blank{
+			template <class Text>
+			bool operator()(const Text& text) const{ return is_blank(text.data(), text.data() + text.size()); }
+		};
+
+		/**
+		 * A predicate matching texts that are not blank (eg. stream->filter(async::text::not_blank{}))
+		 */
+		struct not_blank{
+			template <class Text>
+			bool operator()(const Text& text) const{ return !is_blank(text.data(), text.data() + text.size()); }
+		};
+
+		/**
+		 * A predicate matching base 10 integers
+		 */
+		struct integer{
+			template <class Text>
+			bool operator()(const Text& text) const{ return is_integer(text.data(), text.data() + text.size()); }
+		};
+
+		/**
+		 * A fused validate-and-parse stage (eg. stream->filterMap<int>(async::text::parse_as<int>(onError))), texts that cannot be parsed are reported to the error handler and dropped
+		 * @tparam T - An arithmetic type
+		 * @tparam OnError - OnError :: (const Text&, async::text::parse_error) -> void
+		 */
+		template <class T, class OnError>
+		struct parser{
+			OnError onError; ///< @property onError being the function invoked on each text that cannot be parsed
+
+			template <class Text>
+			bool operator()(const Text& text, T& value) const;
+		};
+
+		/**
+		 * The error handler that ignores errors
+		 */
+		struct ignore_errors{
+			template <class Text>
+			void operator()(const Text&, parse_error) const{}
+		};
+
+		/**
+		 * Create a fused validate-and-parse stage
+		 * @tparam T - An arithmetic type
+		 * @tparam OnError - OnError :: (const Text&, async::text::parse_error) -> void
+		 * @param onError being the function invoked on each text that cannot be parsed (the error channel)
+		 * @return the stage
+		 */
+		template <class T, class OnError = ignore_errors>
+		parser<T, OnError> parse_as(OnError onError = OnError{});
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace async{
+	namespace text{
+		enum class parse_error;
+
+		template <class T>
+		struct parse_result;
+
+		struct blank;
+		struct not_blank;
+		struct integer;
+		struct ignore_errors;
+
+		template <class T, class OnError>
+		struct parser;
+	}
+}
@@ -0,0 +1,315 @@
+#pragma once
+#include <async/text/decl.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace async{
+	namespace details{
+		/**
+		 * Determine whether or not a character is whitespace (like ::isspace in the C locale, without the function call)
+		 */
+		inline bool is_space(char c){
+			return c == ' ' || static_cast<unsigned char>(c - '\t') <= 4;
+		}
+
+		/**
+		 * Determine whether or not a character is a digit (like ::isdigit, without the function call)
+		 */
+		inline bool is_digit(char c){
+			return static_cast<unsigned char>(c - '0') <= 9;
+		}
+
+		/**
+		 * Parse an integer
+		 */
+		template <class T>
+		async::text::parse_result<T> parse_number(const char* first, const char* last, std::true_type){
+			return async::text::parse_integer<T>(first, last);
+		}
+
+		/**
+		 * Parse a floating point number
+		 */
+		template <class T>
+		async::text::parse_result<T> parse_number(const char* first, const char* last, std::false_type){
+			return async::text::parse_float<T>(first, last);
+		}
+
+		/**
+		 * How a floating point type is parsed: the mantissas and powers of ten it holds exactly (a single rounding then
+		 * gives the correctly rounded value) and the C function for the other numbers
+		 * @tparam T The floating point type
+		 */
+		template <class T>
+		struct float_parsing;
+
+		template <>
+		struct float_parsing<float>{
+			static constexpr std::uint64_t exact_mantissa(){ return std::uint64_t{1} << 24; }
+			static constexpr long exact_power(){ return 10; }
+			static float parse(const char* text){ return std::strtof(text, nullptr); }
+		};
+
+		template <>
+		struct float_parsing<double>{
+			static constexpr std::uint64_t exact_mantissa(){ return std::uint64_t{1} << 53; }
+			static constexpr long exact_power(){ return 22; }
+			static double parse(const char* text){ return std::strtod(text, nullptr); }
+		};
+
+		template <>
+		struct float_parsing<long double>{
+			static constexpr std::uint64_t exact_mantissa(){ return std::uint64_t{1} << 53; }
+			static constexpr long exact_power(){ return 22; }
+			static long double parse(const char* text){ return std::strtold(text, nullptr); }
+		};
+	}
+}
+
+inline bool async::text::is_blank(const char* first, const char* last){
+	#ifdef __SSE2__
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i controls = _mm_set1_epi8(4);
+
+	for(; last - first >= 16 ; first += 16){
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+
+		//'\t' to '\r' are contiguous: once shifted down to 0, they are the bytes no greater than 4
+		const __m128i shifted = _mm_sub_epi8(block, tab);
+		const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(shifted, controls), shifted);
+		const __m128i isSpace = _mm_or_si128(_mm_cmpeq_epi8(block, space), isControl);
+
+		if(_mm_movemask_epi8(isSpace) != 0xFFFF)
+			return false;
+	}
+	#endif
+
+	for(; first != last ; ++first){
+		if(!async::details::is_space(*first))
+			return false;
+	}
+
+	return true;
+}
+
+inline bool async::text::is_integer(const char* first, const char* last){
+	if(first != last && *first == '-')
+		++first;
+
+	if(first == last)
+		return false;
+
+	#ifdef __SSE2__
+	const __m128i zero = _mm_set1_epi8('0');
+	const __m128i nine = _mm_set1_epi8(9);
+
+	for(; last - first >= 16 ; first += 16){
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		const __m128i shifted = _mm_sub_epi8(block, zero);
+
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(shifted, nine), shifted)) != 0xFFFF)
+			return false;
+	}
+	#endif
+
+	for(; first != last ; ++first){
+		if(!async::details::is_digit(*first))
+			return false;
+	}
+
+	return true;
+}
+
+template <class T>
+async::text::parse_result<T> async::text::parse_integer(const char* first, const char* last){
+	static_assert(std::is_integral<T>::value, "async::text::parse_integer only parses integral types");
+	using unsigned_type = typename std::make_unsigned<T>::type;
+
+	if(first == last)
+		return {T{}, parse_error::empty};
+
+	const bool negative = *first == '-';
+	if(negative && (!std::is_signed<T>::value || ++first == last))
+		return {T{}, parse_error::invalid};
+
+	const auto limit = static_cast<unsigned_type>(static_cast<unsigned_type>(std::numeric_limits<T>::max()) + (negative ? 1 : 0));
+	unsigned_type value = 0;
+	bool overflow = false;
+
+	for(; first != last ; ++first){
+		const auto digit = static_cast<unsigned>(static_cast<unsigned char>(*first - '0'));
+		if(digit > 9)
+			return {T{}, parse_error::invalid};
+
+		if(overflow || value > (limit - digit) / 10){
+			overflow = true;
+			continue;
+		}
+
+		value = static_cast<unsigned_type>(value * 10 + digit);
+	}
+
+	if(overflow)
+		return {T{}, parse_error::out_of_range};
+
+	if(!negative || value == 0)
+		return {static_cast<T>(value), parse_error::none};
+
+	//-value cannot be computed in T for its minimum
+	return {static_cast<T>(-static_cast<T>(value - 1) - 1), parse_error::none};
+}
+
+template <class T>
+async::text::parse_result<T> async::text::parse_float(const char* first, const char* last){
+	static_assert(std::is_floating_point<T>::value, "async::text::parse_float only parses floating point types");
+	static const double powers[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	if(first == last)
+		return {T{}, parse_error::empty};
+
+	const char* cursor = first;
+	const bool negative = *cursor == '-';
+	if(negative)
+		++cursor;
+
+	std::uint64_t mantissa = 0;
+	int significant = 0;
+	long exponent = 0;
+	bool truncated = false;
+	bool hasDigits = false;
+
+	//At most 19 significant digits fit in the mantissa, the others only move the exponent
+	for(; cursor != last && async::details::is_digit(*cursor) ; ++cursor){
+		hasDigits = true;
+		const auto digit = static_cast<unsigned>(*cursor - '0');
+
+		if(significant < 19){
+			mantissa = mantissa * 10 + digit;
+			significant += mantissa != 0;
+		}else{
+			++exponent;
+			truncated = truncated || digit != 0;
+		}
+	}
+
+	if(cursor != last && *cursor == '.'){
+		for(++cursor ; cursor != last && async::details::is_digit(*cursor) ; ++cursor){
+			hasDigits = true;
+			const auto digit = static_cast<unsigned>(*cursor - '0');
+
+			if(significant < 19){
+				mantissa = mantissa * 10 + digit;
+				significant += mantissa != 0;
+				--exponent;
+			}else
+				truncated = truncated || digit != 0;
+		}
+	}
+
+	if(!hasDigits)
+		return {T{}, parse_error::invalid};
+
+	if(cursor != last && (*cursor == 'e' || *cursor == 'E')){
+		++cursor;
+		const bool negativeExponent = cursor != last && *cursor == '-';
+		if(cursor != last && (*cursor == '-' || *cursor == '+'))
+			++cursor;
+
+		if(cursor == last)
+			return {T{}, parse_error::invalid};
+
+		long written = 0;
+		for(; cursor != last && async::details::is_digit(*cursor) ; ++cursor){
+			if(written < 100000)
+				written = written * 10 + (*cursor - '0');
+		}
+
+		exponent += negativeExponent ? -written : written;
+	}
+
+	if(cursor != last)
+		return {T{}, parse_error::invalid};
+
+	using parsing = async::details::float_parsing<typename std::remove_cv<T>::type>;
+	T value;
+
+	if(mantissa == 0)
+		value = T{};
+	else if(!truncated && mantissa <= parsing::exact_mantissa() && exponent >= -parsing::exact_power() && exponent <= parsing::exact_power()){
+		//Both operands are exact in T: a single rounding, the result is correctly rounded (going through double would round twice)
+		value = static_cast<T>(mantissa);
+		value = exponent < 0 ? value / static_cast<T>(powers[-exponent]) : value * static_cast<T>(powers[exponent]);
+	}else{
+		//The text has been validated, the C function only sees a decimal number (and parses it straight to T)
+		const std::string copy{first, last};
+		errno = 0;
+		value = parsing::parse(copy.c_str());
+
+		if(errno == ERANGE || std::isinf(value))
+			return {T{}, parse_error::out_of_range};
+
+		return {value, parse_error::none};
+	}
+
+	if(negative)
+		value = -value;
+
+	if(std::isinf(value))
+		return {T{}, parse_error::out_of_range};
+
+	return {value, parse_error::none};
+}
+
+template <class T, class Text>
+async::text::parse_result<T> async::text::parse(const Text& text){
+	static_assert(std::is_arithmetic<T>::value, "async::text::parse only parses arithmetic types");
+	return async::details::parse_number<T>(text.data(), text.data() + text.size(), std::is_integral<T>{});
+}
+
+inline const char* async::text::describe(async::text::parse_error error){
+	switch(error){
+		case parse_error::none:
+			return "parsed";
+
+		case parse_error::empty:
+			return "empty text";
+
+		case parse_error::out_of_range:
+			return "number out of range";
+
+		case parse_error::invalid:
+		default:
+			return "not a number";
+	}
+}
+
+template <class T, class OnError>
+template <class Text>
+bool async::text::parser<T, OnError>::operator()(const Text& text, T& value) const{
+	const auto result = async::text::parse<T>(text);
+
+	if(!result){
+		this->onError(text, result.error);
+		return false;
+	}
+
+	value = result.value;
+	return true;
+}
+
+template <class T, class OnError>
+async::text::parser<T, OnError> async::text::parse_as(OnError onError){
+	return parser<T, OnError>{std::move(onError)};
+}
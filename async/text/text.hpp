@@ -0,0 +1,4 @@
+#pragma once
+#include <async/text/fwd.h>
+#include <async/text/decl.h>
+#include <async/text/impl.h>
@@ -0,0 +1,163 @@
+#pragma once
+#include <async/timer/fwd.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <list>
+#include <array>
+#include <unordered_map>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A single thread that runs callbacks once their deadline is reached, shared by every time-based operator
+ * (no thread is needed per window or per stream)
+ *
+ * Deadlines are kept in a hashed hierarchical timing wheel: scheduling and cancelling a callback are O(1), and so is each tick
+ * of the wheel (callbacks due far away are moved closer a level at a time, when the lower level wraps around)
+ */
+class async::timer{
+	public:
+		using clock = std::chrono::steady_clock; ///< @typedef clock being the clock deadlines are measured with
+		using time_point = clock::time_point; ///< @typedef time_point being the type of deadlines
+		using duration = clock::duration; ///< @typedef duration being the type of delays and periods
+		using callback_type = std::function<void()>; ///< @typedef callback_type being the type of callbacks run by the timer
+		using timer_id = std::uint64_t; ///< @typedef timer_id being the type of handles used to cancel a callback
+
+		using tick_type = std::uint64_t; ///< @typedef tick_type being the type of instants, in ticks of the wheel since its construction
+
+		static constexpr std::size_t LEVEL_BITS = 8; ///< @property LEVEL_BITS being the log2 of the amount of slots of a level
+		static constexpr std::size_t SLOTS = std::size_t{1} << LEVEL_BITS; ///< @property SLOTS being the amount of slots of a level
+		static constexpr std::size_t LEVELS = 4; ///< @property LEVELS being the amount of levels (a span of SLOTS^LEVELS ticks, later deadlines wait at the last level)
+
+	protected:
+		/**
+		 * A scheduled callback, as stored in the slots of the wheel
+		 */
+		struct entry{
+			tick_type expiry; ///< @property expiry being the tick the callback is due at
+			tick_type period; ///< @property period being the amount of ticks between two runs (0 for a callback run once)
+			timer_id id; ///< @property id being the handle of the callback
+			std::shared_ptr<callback_type> callback; ///< @property callback being the callback to run (shared between the runs of a periodic callback)
+			std::list<entry>* slot; ///< @property slot being the slot the entry is in
+		};
+
+		using slot_type = std::list<entry>; ///< @typedef slot_type being the type of the slots of the wheel (entries are spliced from slot to slot, never copied)
+
+		mutable std::mutex mutex{}; ///< @property mutex being the mutex used to lock the wheel
+		std::condition_variable cv{}; ///< @property cv being the condition variable the timer thread waits on
+		const duration resolution; ///< @property resolution being the duration of a tick
+		const time_point origin; ///< @property origin being the instant of tick 0
+		std::array<std::array<slot_type, SLOTS>, LEVELS> wheel{}; ///< @property wheel being the slots of each level (level n slots span SLOTS^n ticks)
+		slot_type due{}; ///< @property due being the callbacks whose deadline has been reached, in order
+		std::unordered_map<timer_id, slot_type::iterator> entries{}; ///< @property entries being where each callback that has not been cancelled nor run (if run once) is
+		tick_type current = 0; ///< @property current being the last tick the wheel has been advanced to
+		tick_type wakeup = 0; ///< @property wakeup being the tick the timer thread waits for (or the maximum if it waits for a callback to be scheduled)
+		timer_id nextId = 1; ///< @property nextId being the handle given to the next callback
+		bool stopping = false; ///< @property stopping being the flag used to shutdown the timer thread
+		std::thread thread; ///< @property thread being the thread that runs the callbacks
+
+		/**
+		 * Add a callback to the wheel
+		 * @param delay being the delay before the first run
+		 * @param period being the delay between two runs (zero for a callback run once)
+		 * @param callback being the callback to run
+		 * @return the handle of the callback
+		 */
+		timer_id add(duration delay, duration period, callback_type callback);
+
+		/**
+		 * Move an entry to the slot of its expiry (or to the due callbacks if it has been reached)
+		 * @param from being the slot the entry is in
+		 * @param it being the entry
+		 */
+		void place(slot_type& from, slot_type::iterator it);
+
+		/**
+		 * Advance the wheel by one tick: cascade the levels that wrap around, then move the callbacks of the tick to the due ones
+		 */
+		void advance();
+
+		/**
+		 * Find the tick the timer thread has to wake up at
+		 * @return the next non empty slot of the first level, or the next cascade if there is none before it
+		 */
+		tick_type next_wakeup() const;
+
+		/**
+		 * Convert an instant to ticks
+		 * @param instant being the instant to convert
+		 * @return the last tick reached at that instant
+		 */
+		tick_type tick_of(time_point instant) const;
+
+		/**
+		 * The loop run by the timer thread
+		 */
+		void run();
+
+	public:
+		/**
+		 * Construct a timer, starts its thread
+		 * @param resolution being the duration of a tick, a millisecond by default (callbacks run at the first tick at or after their deadline)
+		 */
+		explicit timer(duration resolution = std::chrono::milliseconds{1});
+
+		timer(const timer&) = delete;
+		timer& operator=(const timer&) = delete;
+
+		/**
+		 * Destructor, stops the timer thread (the callbacks not run yet are discarded)
+		 */
+		~timer();
+
+		/**
+		 * Run a callback once, after the given delay
+		 * @param delay being the delay before the callback is run
+		 * @param callback being the callback to run
+		 * @return the handle to give to async::timer::cancel
+		 * @warning callbacks run on the timer thread: they must be short, must not block and must not throw (eg. hand the work to an executor)
+		 */
+		timer_id schedule(duration delay, callback_type callback);
+
+		/**
+		 * Run a callback periodically, the first run happens after one period
+		 * @param period being the delay between two runs, rounded up to a tick (deadlines do not drift, late runs are not repeated)
+		 * @param callback being the callback to run
+		 * @return the handle to give to async::timer::cancel
+		 * @warning callbacks run on the timer thread: they must be short, must not block and must not throw (eg. hand the work to an executor)
+		 */
+		timer_id scheduleEvery(duration period, callback_type callback);
+
+		/**
+		 * Cancel a callback
+		 * @param id being the handle of the callback
+		 * @return TRUE if the callback will not run anymore, FALSE if it has already been run (or cancelled)
+		 * @warning a run that has already started is not waited for
+		 * @warning handles are only valid for the timer that gave them
+		 */
+		bool cancel(timer_id id);
+
+		/**
+		 * Get the amount of callbacks waiting for their deadline
+		 * @return the amount of scheduled callbacks
+		 */
+		std::size_t pending() const;
+
+		/**
+		 * Get the current time, as measured by the timer
+		 * @return the current time
+		 */
+		static time_point now(){ return clock::now(); }
+};
+
+namespace async{
+	/**
+	 * Retrieve the timer shared by streams that have not been given one (a process-wide timer thread)
+	 * @return the default timer
+	 */
+	shared_timer default_timer();
+}
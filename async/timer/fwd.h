@@ -0,0 +1,8 @@
+#pragma once
+#include <memory>
+
+namespace async{
+	class timer;
+
+	using shared_timer = std::shared_ptr<timer>; ///< @typedef shared_timer being the type that designates a shared pointer to a timer
+}
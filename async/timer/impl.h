@@ -0,0 +1,217 @@
+#pragma once
+#include <async/timer/decl.h>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <limits>
+
+namespace async{
+	namespace details{
+		/**
+		 * Retrieve the timer the calling thread runs the callbacks of
+		 * @return a reference to the thread local timer pointer
+		 */
+		inline const async::timer*& current_timer(){
+			static thread_local const async::timer* timer = nullptr;
+			return timer;
+		}
+	}
+}
+
+#define self async::timer
+#define constructor timer
+
+inline self::constructor(duration resolution)
+: resolution{resolution > duration::zero() ? resolution : duration{1}}, origin{clock::now()}, wakeup{std::numeric_limits<tick_type>::max()}, thread{[this]{ this->run(); }}{
+}
+
+inline self::~constructor(){
+	{
+		std::lock_guard<std::mutex> _{this->mutex};
+		this->stopping = true;
+	}
+
+	this->cv.notify_all();
+
+	//The last reference to a timer may be released by one of its own callbacks: its thread cannot join itself
+	if(this->thread.get_id() == std::this_thread::get_id()){
+		async::details::current_timer() = nullptr;
+		this->thread.detach();
+	}else
+		this->thread.join();
+}
+
+inline self::tick_type self::tick_of(time_point instant) const{
+	return instant > this->origin ? static_cast<tick_type>((instant - this->origin) / this->resolution) : 0;
+}
+
+inline self::timer_id self::add(duration delay, duration period, callback_type callback){
+	bool notify;
+	timer_id id;
+
+	{
+		std::lock_guard<std::mutex> _{this->mutex};
+		const auto now = clock::now();
+
+		//An empty wheel is not advanced by the timer thread
+		if(this->entries.empty() && this->due.empty())
+			this->current = std::max(this->current, this->tick_of(now));
+
+		//Rounded up: a callback never runs before its deadline
+		const auto offset = now + std::max(delay, duration::zero()) - this->origin;
+		const auto ticks = [this](duration value){ return static_cast<tick_type>((value + this->resolution - duration{1}) / this->resolution); };
+
+		id = this->nextId++;
+
+		slot_type staging;
+		staging.push_back(entry{ticks(offset), ticks(period), id, std::make_shared<callback_type>(std::move(callback)), &staging});
+
+		const auto it = staging.begin();
+		this->entries[id] = it;
+		this->place(staging, it);
+
+		notify = it->slot == &this->due || it->expiry < this->wakeup;
+	}
+
+	//Only a new earliest deadline changes how long the timer thread has to wait
+	if(notify)
+		this->cv.notify_one();
+
+	return id;
+}
+
+inline void self::place(slot_type& from, slot_type::iterator it){
+	slot_type* to = &this->due;
+
+	if(it->expiry > this->current){
+		const tick_type delta = it->expiry - this->current;
+		std::size_t level = 0;
+
+		while(level + 1 < LEVELS && (delta >> (LEVEL_BITS * (level + 1))) != 0)
+			++level;
+
+		//Deadlines beyond the last level wait in its furthest slot, they are placed again once it cascades
+		tick_type at = it->expiry;
+		if((delta >> (LEVEL_BITS * LEVELS)) != 0)
+			at = this->current + (tick_type{1} << (LEVEL_BITS * LEVELS)) - 1;
+
+		to = &this->wheel[level][(at >> (LEVEL_BITS * level)) & (SLOTS - 1)];
+	}
+
+	to->splice(to->end(), from, it);
+	it->slot = to;
+}
+
+inline void self::advance(){
+	++this->current;
+
+	std::size_t wrapped = 1;
+	while(wrapped < LEVELS && (this->current & ((tick_type{1} << (LEVEL_BITS * wrapped)) - 1)) == 0)
+		++wrapped;
+
+	//Higher levels first: what they cascade may land in a slot of a lower level that cascades at the same tick
+	for(auto level = wrapped - 1 ; level >= 1 ; --level){
+		auto& slot = this->wheel[level][(this->current >> (LEVEL_BITS * level)) & (SLOTS - 1)];
+		while(!slot.empty())
+			this->place(slot, slot.begin());
+	}
+
+	auto& slot = this->wheel[0][this->current & (SLOTS - 1)];
+	while(!slot.empty())
+		this->place(slot, slot.begin());
+}
+
+inline self::tick_type self::next_wakeup() const{
+	if(!this->due.empty())
+		return this->current;
+
+	//At most a full turn of the first level: its last slot is followed by a cascade
+	for(auto tick = this->current + 1 ; ; ++tick){
+		if((tick & (SLOTS - 1)) == 0 || !this->wheel[0][tick & (SLOTS - 1)].empty())
+			return tick;
+	}
+}
+
+inline self::timer_id self::schedule(duration delay, callback_type callback){
+	return this->add(delay, duration::zero(), std::move(callback));
+}
+
+inline self::timer_id self::scheduleEvery(duration period, callback_type callback){
+	if(period <= duration::zero())
+		throw std::invalid_argument{"The period of a timer callback must be positive"};
+
+	return this->add(period, period, std::move(callback));
+}
+
+inline bool self::cancel(timer_id id){
+	std::lock_guard<std::mutex> _{this->mutex};
+
+	const auto found = this->entries.find(id);
+	if(found == this->entries.end())
+		return false;
+
+	found->second->slot->erase(found->second);
+	this->entries.erase(found);
+	return true;
+}
+
+inline std::size_t self::pending() const{
+	std::lock_guard<std::mutex> _{this->mutex};
+	return this->entries.size();
+}
+
+inline void self::run(){
+	async::details::current_timer() = this;
+	std::unique_lock<std::mutex> lock{this->mutex};
+
+	while(!this->stopping){
+		if(!this->due.empty()){
+			const auto it = this->due.begin();
+			auto callback = it->callback;
+
+			if(it->period == 0){
+				this->entries.erase(it->id);
+				this->due.erase(it);
+			}else{
+				//Skip the periods that have been missed instead of running the callback in a burst
+				it->expiry += it->period * ((this->current - it->expiry) / it->period + 1);
+				this->place(this->due, it);
+			}
+
+			lock.unlock();
+			(*callback)();
+			callback.reset();
+
+			//Releasing the callback may have destroyed this timer
+			if(async::details::current_timer() != this)
+				return;
+
+			lock.lock();
+			continue;
+		}
+
+		if(this->entries.empty()){
+			this->wakeup = std::numeric_limits<tick_type>::max();
+			this->cv.wait(lock);
+			continue;
+		}
+
+		//Catching up is done a tick at a time, each tick only touches the slots it reaches
+		if(this->current < this->tick_of(clock::now())){
+			this->advance();
+			continue;
+		}
+
+		this->wakeup = this->next_wakeup();
+		this->cv.wait_until(lock, this->origin + this->resolution * static_cast<duration::rep>(this->wakeup));
+	}
+}
+
+#undef self
+#undef constructor
+
+
+inline async::shared_timer async::default_timer(){
+	static shared_timer timer = std::make_shared<async::timer>();
+	return timer;
+}
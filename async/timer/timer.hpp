@@ -0,0 +1,4 @@
+#pragma once
+#include <async/timer/fwd.h>
+#include <async/timer/decl.h>
+#include <async/timer/impl.h>
@@ -0,0 +1,174 @@
+#pragma once
+#include <async/trace/fwd.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef ASYNC_TRACE_CAPACITY
+/**
+ * @def ASYNC_TRACE_CAPACITY
+ * The amount of events each thread keeps (the oldest ones are overwritten), rounded up to a power of two
+ */
+#define ASYNC_TRACE_CAPACITY 65536
+#endif
+
+/**
+ * What happened
+ */
+enum class async::trace::event_kind : unsigned char{
+	task_start, ///< A task handler starts running
+	task_stop, ///< A task handler has returned (or thrown)
+	emit, ///< Values have been emitted on a stream
+	listener_enter, ///< A listener is handed a value or a batch
+	listener_exit, ///< A listener has returned
+	close, ///< A stream has been closed
+	complete, ///< Every value of a closed stream has been delivered
+};
+
+/**
+ * An event as recorded in a ring
+ */
+struct async::trace::event{
+	std::uint64_t timestamp; ///< @property timestamp being when it happened (see async::trace::ticks)
+	const void* object; ///< @property object being the task or stream it happened to
+	std::uint64_t argument; ///< @property argument being the amount of values emitted, the listener's subscription or the task's stream
+	async::trace::event_kind kind; ///< @property kind being what happened
+};
+
+/**
+ * The events recorded by a thread: written by that thread only (without locking), read when the trace is written
+ */
+class async::trace::ring{
+	protected:
+		std::vector<async::trace::event> events; ///< @property events being the storage of the ring
+		std::size_t mask; ///< @property mask being the capacity of the ring minus one
+		std::size_t thread; ///< @property thread being the number of the thread that records the events
+		std::atomic<std::uint64_t> head{0}; ///< @property head being the amount of events ever recorded
+		std::atomic<std::uint64_t> tail{0}; ///< @property tail being the amount of events that have been cleared
+
+	public:
+		/**
+		 * Construct an empty ring
+		 * @param capacity being the amount of events to keep (rounded up to a power of two)
+		 * @param thread being the number of the thread that records the events
+		 */
+		ring(std::size_t capacity, std::size_t thread);
+
+		ring(const ring&) = delete;
+		ring& operator=(const ring&) = delete;
+
+		/**
+		 * Record an event, overwriting the oldest one if the ring is full
+		 * @param event being the event to record
+		 * @pre Called from the thread that owns this ring
+		 */
+		void push(const async::trace::event& event){
+			const auto index = this->head.load(std::memory_order_relaxed);
+			this->events[index & this->mask] = event;
+			this->head.store(index + 1, std::memory_order_release);
+		}
+
+		/**
+		 * Copy the events kept by this ring, oldest first
+		 * @return the events recorded since the last clear (at most the capacity)
+		 * @warning events recorded while copying may be torn, take snapshots once the work is done
+		 */
+		std::vector<async::trace::event> snapshot() const;
+
+		/**
+		 * Forget the events recorded so far
+		 */
+		void clear(){ this->tail.store(this->head.load(std::memory_order_acquire), std::memory_order_release); }
+
+		/**
+		 * Get the number of the thread that records the events
+		 * @return the number of the thread (in order of first event, a thread that exited hands its number to the next one along with its ring)
+		 */
+		std::size_t threadNumber() const{ return this->thread; }
+};
+
+/**
+ * The rings of every thread that recorded an event (they outlive their thread so its events can still be written,
+ * then go to the next thread that records one, so that short lived threads do not each keep a ring)
+ */
+struct async::details::trace_registry{
+	/**
+	 * Hands the ring of a thread back to the registry when the thread exits
+	 */
+	struct owner{
+		std::shared_ptr<async::trace::ring> ring; ///< @property ring being the ring of the thread
+
+		~owner();
+	};
+
+	std::mutex mutex{}; ///< @property mutex being the mutex used to lock the list of rings
+	std::vector<std::shared_ptr<async::trace::ring>> rings{}; ///< @property rings being the rings that may hold events
+	std::vector<std::shared_ptr<async::trace::ring>> released{}; ///< @property released being the rings of the threads that have exited, reused before creating new ones
+	std::size_t threads = 0; ///< @property threads being the amount of rings created so far
+	std::uint64_t originTicks = 0; ///< @property originTicks being the ticks the trace starts at
+	std::uint64_t originNanoseconds = 0; ///< @property originNanoseconds being the steady clock time the trace starts at
+
+	trace_registry();
+
+	/**
+	 * Get the registry
+	 * @return the process wide registry
+	 */
+	static trace_registry& instance();
+
+	/**
+	 * Get a ring for a thread that starts recording: one released by an exited thread, or a new one
+	 * @return the ring, owned by the caller until it is released
+	 */
+	std::shared_ptr<async::trace::ring> acquire();
+
+	/**
+	 * Get the ring of the calling thread, acquired on first use and released when the thread exits
+	 * @return the ring of the calling thread
+	 */
+	static async::trace::ring& local();
+};
+
+namespace async{
+	namespace trace{
+		/**
+		 * Read the timestamp counter (the CPU's TSC on x86, the steady clock in nanoseconds elsewhere)
+		 * @return the current amount of ticks
+		 */
+		inline std::uint64_t ticks();
+
+		/**
+		 * Record an event in the ring of the calling thread (no lock, no allocation after the first event of a thread)
+		 * @param kind being what happened
+		 * @param object being the task or stream it happened to
+		 * @param argument being the details of the event (see async::trace::event::argument)
+		 */
+		inline void record(async::trace::event_kind kind, const void* object, std::uint64_t argument = 0){
+			async::details::trace_registry::local().push(async::trace::event{async::trace::ticks(), object, argument, kind});
+		}
+
+		/**
+		 * Write the recorded events as Chrome trace JSON (to load in chrome://tracing or ui.perfetto.dev)
+		 * @param out being the stream to write to
+		 * @return out
+		 */
+		inline std::ostream& write(std::ostream& out);
+
+		/**
+		 * Write the recorded events as Chrome trace JSON to a file
+		 * @param path being the path of the file
+		 * @throws std::runtime_error if the file cannot be opened
+		 */
+		inline void flush(const std::string& path);
+
+		/**
+		 * Forget the events recorded so far by every thread (and free the rings of the threads that have exited)
+		 */
+		inline void clear();
+	}
+}
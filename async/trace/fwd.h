@@ -0,0 +1,17 @@
+#pragma once
+
+namespace async{
+	/**
+	 * @namespace async::trace
+	 * A flight recorder of the events of tasks and streams, exported in the Chrome trace format (see ASYNC_TRACE)
+	 */
+	namespace trace{
+		enum class event_kind : unsigned char;
+		struct event;
+		class ring;
+	}
+
+	namespace details{
+		struct trace_registry;
+	}
+}
@@ -0,0 +1,264 @@
+#pragma once
+#include <async/trace/decl.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define ASYNC_TRACE_TSC 1
+#endif
+
+namespace async{
+	namespace details{
+		/**
+		 * Get the current time of the steady clock
+		 * @return the amount of nanoseconds since the epoch of std::chrono::steady_clock
+		 */
+		inline std::uint64_t trace_nanoseconds(){
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()
+			).count());
+		}
+	}
+}
+
+inline std::uint64_t async::trace::ticks(){
+	#ifdef ASYNC_TRACE_TSC
+	return __rdtsc();
+	#else
+	return async::details::trace_nanoseconds();
+	#endif
+}
+
+
+#define self async::trace::ring
+#define constructor ring
+
+inline self::constructor(std::size_t capacity, std::size_t thread) : thread{thread}{
+	std::size_t size = 1;
+	while(size < capacity)
+		size <<= 1;
+
+	this->events.resize(size);
+	this->mask = size - 1;
+}
+
+inline std::vector<async::trace::event> self::snapshot() const{
+	const auto head = this->head.load(std::memory_order_acquire);
+	const auto tail = this->tail.load(std::memory_order_acquire);
+	const auto first = std::max<std::uint64_t>(tail, head > this->events.size() ? head - this->events.size() : 0);
+
+	std::vector<async::trace::event> events;
+	events.reserve(static_cast<std::size_t>(head - first));
+
+	for(auto i = first ; i < head ; ++i)
+		events.push_back(this->events[i & this->mask]);
+
+	return events;
+}
+
+#undef self
+#undef constructor
+
+
+#define self async::details::trace_registry
+#define constructor trace_registry
+
+inline self::constructor() : originTicks{async::trace::ticks()}, originNanoseconds{async::details::trace_nanoseconds()}{
+}
+
+inline self& self::instance(){
+	static self registry;
+	return registry;
+}
+
+inline std::shared_ptr<async::trace::ring> self::acquire(){
+	std::lock_guard<std::mutex> _{this->mutex};
+
+	if(!this->released.empty()){
+		auto ring = std::move(this->released.back());
+		this->released.pop_back();
+		return ring;
+	}
+
+	this->rings.push_back(std::make_shared<async::trace::ring>(ASYNC_TRACE_CAPACITY, ++this->threads));
+	return this->rings.back();
+}
+
+inline async::trace::ring& self::local(){
+	static thread_local async::trace::ring* ring = nullptr;
+
+	if(!ring){
+		//The owner is only reached on the first event of a thread, the fast path does not pay for its guard
+		static thread_local self::owner owner{self::instance().acquire()};
+		ring = owner.ring.get();
+	}
+
+	return *ring;
+}
+
+inline self::owner::~owner(){
+	//The events stay in the ring (and in the trace) until they are cleared or overwritten by the next thread
+	auto& registry = self::instance();
+	std::lock_guard<std::mutex> _{registry.mutex};
+	registry.released.push_back(std::move(this->ring));
+}
+
+#undef self
+#undef constructor
+
+
+namespace async{
+	namespace details{
+		/**
+		 * Get how an event shows up in a trace
+		 * @param kind being what happened
+		 * @return the name of the event
+		 */
+		inline const char* trace_name(async::trace::event_kind kind){
+			switch(kind){
+				case async::trace::event_kind::task_start:
+				case async::trace::event_kind::task_stop:
+					return "task";
+
+				case async::trace::event_kind::emit:
+					return "emit";
+
+				case async::trace::event_kind::listener_enter:
+				case async::trace::event_kind::listener_exit:
+					return "listener";
+
+				case async::trace::event_kind::close:
+					return "close";
+
+				case async::trace::event_kind::complete:
+				default:
+					return "complete";
+			}
+		}
+
+		/**
+		 * Get the Chrome trace phase of an event: begin, end or instant
+		 * @param kind being what happened
+		 * @return the phase of the event
+		 */
+		inline char trace_phase(async::trace::event_kind kind){
+			switch(kind){
+				case async::trace::event_kind::task_start:
+				case async::trace::event_kind::listener_enter:
+					return 'B';
+
+				case async::trace::event_kind::task_stop:
+				case async::trace::event_kind::listener_exit:
+					return 'E';
+
+				default:
+					return 'i';
+			}
+		}
+
+		/**
+		 * Get the name of the argument of an event
+		 * @param kind being what happened
+		 * @return the name of the argument (nullptr if the event has none)
+		 */
+		inline const char* trace_argument(async::trace::event_kind kind){
+			switch(kind){
+				case async::trace::event_kind::task_start:
+					return "stream";
+
+				case async::trace::event_kind::emit:
+					return "count";
+
+				case async::trace::event_kind::listener_enter:
+					return "subscription";
+
+				default:
+					return nullptr;
+			}
+		}
+	}
+}
+
+inline std::ostream& async::trace::write(std::ostream& out){
+	auto& registry = async::details::trace_registry::instance();
+
+	std::vector<std::shared_ptr<async::trace::ring>> rings;
+	{
+		std::lock_guard<std::mutex> _{registry.mutex};
+		rings = registry.rings;
+	}
+
+	//The ticks are converted to microseconds with the rate measured between the origin and now
+	const auto elapsedTicks = async::trace::ticks() - registry.originTicks;
+	const auto elapsedNanoseconds = async::details::trace_nanoseconds() - registry.originNanoseconds;
+	const double ticksPerMicrosecond = elapsedNanoseconds == 0 ? 1000.0 : 1000.0 * static_cast<double>(elapsedTicks) / static_cast<double>(elapsedNanoseconds);
+
+	const auto flags = out.flags();
+	const auto precision = out.precision();
+	out.setf(std::ios::fixed, std::ios::floatfield);
+	out.precision(3);
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+
+	for(const auto& ring : rings){
+		for(const auto& event : ring->snapshot()){
+			const auto timestamp = event.timestamp < registry.originTicks ? 0 : event.timestamp - registry.originTicks;
+			const auto phase = async::details::trace_phase(event.kind);
+
+			out << (first ? "\n" : ",\n")
+				<< "{\"name\":\"" << async::details::trace_name(event.kind) << "\""
+				<< ",\"ph\":\"" << phase << "\""
+				<< ",\"ts\":" << static_cast<double>(timestamp) / ticksPerMicrosecond
+				<< ",\"pid\":1,\"tid\":" << ring->threadNumber();
+
+			if(phase == 'i')
+				out << ",\"s\":\"t\"";
+
+			out << ",\"args\":{\"object\":\"" << event.object << "\"";
+			if(const char* argument = async::details::trace_argument(event.kind)){
+				out << ",\"" << argument << "\":";
+
+				if(event.kind == async::trace::event_kind::task_start)
+					out << '"' << reinterpret_cast<const void*>(static_cast<std::uintptr_t>(event.argument)) << '"';
+				else
+					out << event.argument;
+			}
+
+			out << "}}";
+			first = false;
+		}
+	}
+
+	out << "\n]}\n";
+
+	out.flags(flags);
+	out.precision(precision);
+	return out;
+}
+
+inline void async::trace::flush(const std::string& path){
+	std::ofstream file{path};
+	if(!file.is_open())
+		throw std::runtime_error("Cannot open the trace file " + path);
+
+	async::trace::write(file);
+}
+
+inline void async::trace::clear(){
+	auto& registry = async::details::trace_registry::instance();
+	std::lock_guard<std::mutex> _{registry.mutex};
+
+	for(const auto& ring : registry.rings)
+		ring->clear();
+
+	//The rings of the threads that have exited are empty now, there is no need to keep them around
+	for(const auto& ring : registry.released)
+		registry.rings.erase(std::find(registry.rings.begin(), registry.rings.end(), ring));
+
+	registry.released.clear();
+}
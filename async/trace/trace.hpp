@@ -0,0 +1,4 @@
+#pragma once
+#include <async/trace/fwd.h>
+#include <async/trace/decl.h>
+#include <async/trace/impl.h>
@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace bench
+ * A self-contained benchmark harness: each benchmark reports its throughput and the distribution of its latencies
+ */
+namespace bench{
+	using clock_type = std::chrono::steady_clock; ///< @typedef clock_type being the clock used to measure durations
+
+	/**
+	 * Get the current time in nanoseconds
+	 * @return the time elapsed since the epoch of bench::clock_type
+	 */
+	inline std::uint64_t now(){
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count());
+	}
+
+	/**
+	 * What a benchmark measured
+	 */
+	struct result{
+		std::uint64_t operations = 0; ///< @property operations being the amount of operations run
+		std::uint64_t elapsed = 0; ///< @property elapsed being the time it took to run them (in nanoseconds)
+		std::vector<std::uint64_t> latencies{}; ///< @property latencies being the latency samples (in nanoseconds)
+	};
+
+	/**
+	 * A named benchmark
+	 */
+	struct benchmark{
+		std::string name; ///< @property name being the name of the benchmark (reported, matched by the filter)
+		std::function<result(std::uint64_t)> run; ///< @property run being the function that runs the given amount of operations
+		std::uint64_t operations; ///< @property operations being the default amount of operations
+	};
+
+	/**
+	 * Get a percentile of sorted samples
+	 * @param sorted being the samples (sorted)
+	 * @param percentile being the percentile (between 0 and 1)
+	 * @return the sample at that percentile, 0 if there is none
+	 */
+	inline std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, double percentile){
+		if(sorted.empty())
+			return 0;
+
+		const auto index = static_cast<std::size_t>(percentile * static_cast<double>(sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	/**
+	 * The registered benchmarks
+	 * @return the list of benchmarks
+	 */
+	inline std::vector<benchmark>& registry(){
+		static std::vector<benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	/**
+	 * Register a benchmark
+	 * @param name being the name of the benchmark
+	 * @param operations being the default amount of operations
+	 * @param run being the function that runs the given amount of operations
+	 */
+	inline void add(std::string name, std::uint64_t operations, std::function<result(std::uint64_t)> run){
+		registry().push_back(benchmark{std::move(name), std::move(run), operations});
+	}
+
+	/**
+	 * Run the registered benchmarks and print a report
+	 * @param argc being the amount of command line arguments
+	 * @param argv being the command line arguments ([filter] [--scale=factor])
+	 * @return the exit code
+	 */
+	inline int run(int argc, char** argv){
+		std::string filter;
+		double scale = 1.0;
+
+		for(int i = 1 ; i < argc ; ++i){
+			if(std::strncmp(argv[i], "--scale=", 8) == 0)
+				scale = std::atof(argv[i] + 8);
+			else
+				filter = argv[i];
+		}
+
+		std::printf("%-36s %12s %14s %10s %10s %10s\n", "benchmark", "ops", "ops/sec", "p50 (ns)", "p99 (ns)", "p999 (ns)");
+
+		for(const auto& benchmark : registry()){
+			if(!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+				continue;
+
+			const auto operations = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(static_cast<double>(benchmark.operations) * scale));
+			auto measured = benchmark.run(operations);
+			std::sort(measured.latencies.begin(), measured.latencies.end());
+
+			const double seconds = static_cast<double>(std::max<std::uint64_t>(1, measured.elapsed)) / 1e9;
+			std::printf(
+				"%-36s %12llu %14.0f %10llu %10llu %10llu\n",
+				benchmark.name.c_str(),
+				static_cast<unsigned long long>(measured.operations),
+				static_cast<double>(measured.operations) / seconds,
+				static_cast<unsigned long long>(percentile(measured.latencies, 0.5)),
+				static_cast<unsigned long long>(percentile(measured.latencies, 0.99)),
+				static_cast<unsigned long long>(percentile(measured.latencies, 0.999))
+			);
+			std::fflush(stdout);
+		}
+
+		return 0;
+	}
+}
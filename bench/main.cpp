@@ -0,0 +1,306 @@
+#include <async/async.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "harness.h"
+
+/**
+ * A value of the given size (at least 8 bytes) that carries the time it was emitted at
+ * @tparam Size - The size of the value in bytes
+ */
+template <std::size_t Size>
+struct payload{
+	std::uint64_t stamp; ///< @property stamp being the time the value was emitted at
+	char bytes[Size - sizeof(std::uint64_t) + 1]; ///< @property bytes being the rest of the value
+};
+
+/**
+ * A mapper that leaves the values untouched (but still costs a stage)
+ * @tparam Stage - Gives each stage its own empty type, so that the chain takes no room in the listener
+ */
+template <int Stage>
+struct identity{
+	std::uint64_t operator()(const std::uint64_t& value) const{ return value; }
+};
+
+/**
+ * Appends Depth identity maps to a fused pipeline
+ * @tparam Depth - The amount of stages to append
+ */
+template <int Depth>
+struct fused_chain{
+	template <class Pipeline>
+	static auto apply(const Pipeline& pipeline) -> decltype(fused_chain<Depth - 1>::apply(pipeline.template map<std::uint64_t>(identity<Depth>{}))){
+		return fused_chain<Depth - 1>::apply(pipeline.template map<std::uint64_t>(identity<Depth>{}));
+	}
+};
+
+template <>
+struct fused_chain<0>{
+	template <class Pipeline>
+	static Pipeline apply(const Pipeline& pipeline){ return pipeline; }
+};
+
+/**
+ * Emit values of the given size to a single listener
+ * @tparam Size - The size of the values in bytes
+ */
+template <std::size_t Size>
+bench::result emitThroughput(std::uint64_t operations){
+	bench::result result;
+	result.latencies.reserve(operations);
+	auto& latencies = result.latencies;
+
+	async::stream<payload<Size>> stream;
+	stream.onValue([&latencies](const payload<Size>& value){
+		latencies.push_back(bench::now() - value.stamp);
+	});
+
+	const auto start = bench::now();
+	for(std::uint64_t i = 0 ; i < operations ; ++i){
+		payload<Size> value;
+		value.stamp = bench::now();
+		stream.emit(value);
+	}
+
+	stream.close();
+	stream.wait();
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	return result;
+}
+
+/**
+ * Emit values to several listeners, the latency is measured by the last one
+ * @param listeners being the amount of listeners
+ */
+bench::result fanOut(std::uint64_t operations, std::size_t listeners){
+	bench::result result;
+	result.latencies.reserve(operations);
+	auto& latencies = result.latencies;
+	std::atomic<std::uint64_t> received{0};
+
+	async::stream<std::uint64_t> stream;
+	for(std::size_t i = 1 ; i < listeners ; ++i){
+		stream.onValue([&received](const std::uint64_t&){
+			received.fetch_add(1, std::memory_order_relaxed);
+		});
+	}
+
+	stream.onValue([&latencies](const std::uint64_t& stamp){
+		latencies.push_back(bench::now() - stamp);
+	});
+
+	const auto start = bench::now();
+	for(std::uint64_t i = 0 ; i < operations ; ++i)
+		stream.emit(bench::now());
+
+	stream.close();
+	stream.wait();
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	return result;
+}
+
+/**
+ * Emit values through a chain of map streams
+ * @param depth being the amount of maps
+ */
+bench::result chainedMaps(std::uint64_t operations, std::size_t depth){
+	bench::result result;
+	result.latencies.reserve(operations);
+	auto& latencies = result.latencies;
+
+	async::stream<std::uint64_t> stream;
+	std::vector<std::shared_ptr<async::stream<std::uint64_t>>> chain;
+	async::stream<std::uint64_t>* last = &stream;
+
+	for(std::size_t i = 0 ; i < depth ; ++i){
+		chain.push_back(last->mapTo<std::uint64_t>(identity<0>{}));
+		last = chain.back().get();
+	}
+
+	last->forEach([&latencies](const std::uint64_t& stamp){
+		latencies.push_back(bench::now() - stamp);
+	});
+
+	const auto start = bench::now();
+	for(std::uint64_t i = 0 ; i < operations ; ++i)
+		stream.emit(bench::now());
+
+	stream.close();
+	last->wait();
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	return result;
+}
+
+/**
+ * Emit values through a fused pipeline of maps
+ * @tparam Depth - The amount of maps
+ */
+template <int Depth>
+bench::result fusedMaps(std::uint64_t operations){
+	bench::result result;
+	result.latencies.reserve(operations);
+	auto& latencies = result.latencies;
+
+	async::stream<std::uint64_t> stream;
+	fused_chain<Depth>::apply(stream.fuse()).forEach([&latencies](const std::uint64_t& stamp){
+		latencies.push_back(bench::now() - stamp);
+	});
+
+	const auto start = bench::now();
+	for(std::uint64_t i = 0 ; i < operations ; ++i)
+		stream.emit(bench::now());
+
+	stream.close();
+	stream.wait();
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	return result;
+}
+
+/**
+ * Emit values from several threads into a single stream
+ * @param producers being the amount of producer threads
+ * @param mode being the kind of queue of the stream
+ */
+bench::result fanIn(std::uint64_t operations, std::size_t producers, async::queue_mode mode){
+	bench::result result;
+	result.latencies.reserve(operations);
+	auto& latencies = result.latencies;
+
+	async::stream<std::uint64_t> stream{async::stream_options{}.withMode(mode)};
+	stream.onValue([&latencies](const std::uint64_t& stamp){
+		latencies.push_back(bench::now() - stamp);
+	});
+
+	const auto start = bench::now();
+	std::vector<std::thread> threads;
+	for(std::size_t i = 0 ; i < producers ; ++i){
+		threads.emplace_back([&stream, operations, producers, i]{
+			const auto count = operations / producers + (i < operations % producers ? 1 : 0);
+			for(std::uint64_t j = 0 ; j < count ; ++j)
+				stream.emit(bench::now());
+		});
+	}
+
+	for(auto& thread : threads)
+		thread.join();
+
+	stream.close();
+	stream.wait();
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	return result;
+}
+
+/**
+ * Run empty tasks one after the other, the latency is the time from construction to the end of wait
+ */
+bench::result taskSpawn(std::uint64_t operations){
+	bench::result result;
+	result.latencies.reserve(operations);
+
+	const auto start = bench::now();
+	for(std::uint64_t i = 0 ; i < operations ; ++i){
+		const auto begin = bench::now();
+		async::task<int> task{[](async::task<int>&, async::stream<int>&){}};
+		task.run().wait();
+		result.latencies.push_back(bench::now() - begin);
+	}
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	return result;
+}
+
+/**
+ * Run empty jobs through a task group, the latency is the time from scheduling to execution
+ */
+bench::result groupSpawn(std::uint64_t operations){
+	bench::result result;
+	std::vector<std::uint64_t> started(operations);
+
+	const auto start = bench::now();
+	{
+		async::task_group group;
+		for(std::uint64_t i = 0 ; i < operations ; ++i){
+			const auto scheduled = bench::now();
+			auto* slot = &started[i];
+			group.run([slot, scheduled]{
+				*slot = bench::now() - scheduled;
+			});
+		}
+
+		group.wait();
+	}
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	result.latencies = std::move(started);
+	return result;
+}
+
+/**
+ * Close streams that have a value pending, the latency is the time close and wait take
+ */
+bench::result closeWait(std::uint64_t operations){
+	bench::result result;
+	result.latencies.reserve(operations);
+	std::atomic<std::uint64_t> received{0};
+
+	const auto start = bench::now();
+	for(std::uint64_t i = 0 ; i < operations ; ++i){
+		async::stream<int> stream;
+		stream.onValue([&received](const int&){
+			received.fetch_add(1, std::memory_order_relaxed);
+		});
+		stream.emit(1);
+
+		const auto begin = bench::now();
+		stream.close();
+		stream.wait();
+		result.latencies.push_back(bench::now() - begin);
+	}
+
+	result.elapsed = bench::now() - start;
+	result.operations = operations;
+	return result;
+}
+
+int main(int argc, char** argv){
+	bench::add("emit/payload:16", 1000000, emitThroughput<16>);
+	bench::add("emit/payload:64", 1000000, emitThroughput<64>);
+	bench::add("emit/payload:256", 500000, emitThroughput<256>);
+	bench::add("emit/payload:1024", 200000, emitThroughput<1024>);
+
+	for(std::size_t listeners : {1, 4, 16})
+		bench::add("fan-out/listeners:" + std::to_string(listeners), 500000, [listeners](std::uint64_t operations){ return fanOut(operations, listeners); });
+
+	for(std::size_t depth : {1, 4, 16})
+		bench::add("chain/map-streams:" + std::to_string(depth), 200000, [depth](std::uint64_t operations){ return chainedMaps(operations, depth); });
+
+	bench::add("chain/fused-maps:1", 500000, fusedMaps<1>);
+	bench::add("chain/fused-maps:4", 500000, fusedMaps<4>);
+	bench::add("chain/fused-maps:16", 500000, fusedMaps<16>);
+
+	for(std::size_t producers : {1, 4}){
+		bench::add("fan-in/locked/producers:" + std::to_string(producers), 500000, [producers](std::uint64_t operations){ return fanIn(operations, producers, async::queue_mode::locked); });
+		bench::add("fan-in/mpmc/producers:" + std::to_string(producers), 500000, [producers](std::uint64_t operations){ return fanIn(operations, producers, async::queue_mode::mpmc); });
+	}
+
+	bench::add("task/spawn-run-wait", 20000, taskSpawn);
+	bench::add("task/group-job", 500000, groupSpawn);
+	bench::add("stream/close-wait", 20000, closeWait);
+
+	return bench::run(argc, argv);
+}
@@ -1,55 +1,28 @@
 #include <iostream>
-#include <fstream>
 #include <async/async.hpp>
-#include <functional>
 #include "utils.h"
 
-using namespace std::placeholders;
-
-template <class Str=std::string>
-void streamFile(const char* path, async::task<Str>& task, async::stream<Str>& stream){
-	std::ifstream file{path};
-
-	if(!file.is_open())
-		task.stop("Could not open file");
-
-	while(file.good()){
-		Str tmp;
-		std::getline(file, tmp);
-		stream << tmp;
-	}
-
-	if(!file.eof())
-		task.stop("Stopped reading before EOF");
-}
-
 void testLoremIpsum(){
-	/*async::task<std::string> task([](async::task<std::string>& task, async::stream<std::string>& stream){
-		streamFile("../test.txt", task, stream);
-	});*/
-	async::task<std::string> task(std::bind(
-		streamFile<>,
-		"../test.txt", _1, _2
-	));
+	//Reading the file blocks, the producer gets a thread of its own instead of a worker of the default task executor
+	async::task<async::line_view> task{async::sources::lines("../test.txt"), std::make_shared<async::dedicated_thread_executor>()};
 
 	task->stream()
-	->filter(is_not_whitespace)
-	->forEach(cli::wrap::log("$[> ", " <]$\n"));
+	->filter(async::text::not_blank{})
+	->forEach(cli::wrap::log<async::line_view>("$[> ", " <]$\n"));
 
 	task->run()->wait();
 }
 
 void testNumber(){
-	async::task<std::string> task(std::bind(
-		streamFile<>,
-		"../num.txt", _1, _2
-	));
+	async::task<async::line_view> task{async::sources::lines("../num.txt"), std::make_shared<async::dedicated_thread_executor>()};
 
 	task->stream()
-	->filter(is_not_whitespace)
-	->filter(is_int<>)
-	->mapTo<int>(to_int<>)
-	->forEach(cli::wrap::log<int>("$> ", " <$"));
+	->fuse()
+	.filter(async::text::not_blank{})
+	.filterMap<int>(async::text::parse_as<int>([](const async::line_view& line, async::text::parse_error error){
+		std::cerr << "Skipped \"" << line << "\" (" << async::text::describe(error) << ")\n";
+	}))
+	.forEach(cli::wrap::log<int>("$> ", " <$"));
 
 	task->run()->wait();
 }
@@ -1,16 +1,19 @@
 #pragma once
-#include <regex>
 #include <string>
 #include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <async/text/text.hpp>
 #include "console.h"
 
-bool is_whitespace(const std::string& str){
-	static std::regex emptystr{"^\\s*$"};
-	return std::regex_search(str, emptystr);
+template <class Str=std::string>
+bool is_whitespace(const Str& str){
+	return async::text::blank{}(str);
 }
 
-bool is_not_whitespace(const std::string& str){
-	return !is_whitespace(str);
+template <class Str=std::string>
+bool is_not_whitespace(const Str& str){
+	return async::text::not_blank{}(str);
 }
 
 std::wstring string_to_wstring(const std::string& str){
@@ -31,5 +34,12 @@ bool is_int(int i){ return true; }
 
 template <class Str=std::string>
 int to_int(const Str& str){
-	return std::stoi(str, nullptr, 10);
+	const auto result = async::text::parse<int>(str);
+
+	if(result.error == async::text::parse_error::out_of_range)
+		throw std::out_of_range{"to_int"};
+	else if(!result)
+		throw std::invalid_argument{"to_int"};
+
+	return result.value;
 }
\ No newline at end of file